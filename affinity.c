@@ -0,0 +1,284 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "affinity.h"
+
+int affinity_bind = BIND_NONE;
+char *affinity_name = "none";
+
+/* placement of every thread of the current team, filled by affinity_apply() */
+static cpu_place_t *placement = NULL;
+static int placement_n = 0;
+
+#ifdef __linux__
+
+/* logical CPUs available to the process */
+static cpu_place_t *cpus = NULL;
+static int ncpus = 0;
+
+/* CPUs in binding order, as indexes into cpus[] */
+static int *order = NULL;
+static int norder = 0;
+
+static char *bind_list = NULL;
+
+int affinity_select(char *b){
+
+  if (strcmp(b, "none") == 0) affinity_bind = BIND_NONE;
+  else if (strcmp(b, "compact") == 0) affinity_bind = BIND_COMPACT;
+  else if (strcmp(b, "cores") == 0) affinity_bind = BIND_CORES;
+  else if (strcmp(b, "scatter") == 0) affinity_bind = BIND_SCATTER;
+  else if (strspn(b, "0123456789,-") == strlen(b) && b[0] != '\0') {
+    affinity_bind = BIND_LIST;
+    bind_list = b;
+  }
+  else {
+    fprintf(stderr, "ERROR: unknown binding %s, use none, compact, cores, scatter or a CPU list\n", b);
+    return 1;
+  }
+
+  affinity_name = b;
+  return 0;
+}
+
+static int read_topology(int cpu, char *name){
+
+  char path[128];
+  FILE *f;
+  int v = -1;
+
+  sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+  f = fopen(path, "r");
+  if (f) {
+    if (fscanf(f, "%d", &v) != 1) v = -1;
+    fclose(f);
+  }
+
+  return v;
+}
+
+/* read socket and core of every CPU in the process affinity mask */
+static int load_topology(){
+
+  cpu_set_t mask;
+  int c, i;
+
+  if (sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+    fprintf(stderr, "ERROR: unable to read the process affinity mask\n");
+    return 1;
+  }
+
+  cpus = (cpu_place_t *)malloc(CPU_COUNT(&mask) * sizeof(cpu_place_t));
+  if (!cpus) return 1;
+
+  for (c = 0; c < CPU_SETSIZE; c++) {
+    if (!CPU_ISSET(c, &mask)) continue;
+    cpus[ncpus].cpu = c;
+    cpus[ncpus].socket = read_topology(c, "physical_package_id");
+    cpus[ncpus].core = read_topology(c, "core_id");
+    if (cpus[ncpus].socket < 0) cpus[ncpus].socket = 0;
+    if (cpus[ncpus].core < 0) cpus[ncpus].core = c;
+
+    /* SMT index: number of siblings on the same core seen so far */
+    cpus[ncpus].smt = 0;
+    for (i = 0; i < ncpus; i++) {
+      if (cpus[i].socket == cpus[ncpus].socket && cpus[i].core == cpus[ncpus].core) cpus[ncpus].smt++;
+    }
+    ncpus++;
+  }
+
+  return 0;
+}
+
+/* position of a CPU's core among the cores of its socket */
+static int core_rank(cpu_place_t *p){
+
+  int i, rank = 0;
+
+  for (i = 0; i < ncpus; i++) {
+    if (cpus[i].socket == p->socket && cpus[i].smt == 0 && cpus[i].core < p->core) rank++;
+  }
+
+  return rank;
+}
+
+static long sort_key(cpu_place_t *p){
+  switch (affinity_bind) {
+  case BIND_CORES:
+    return ((long)p->smt << 40) | ((long)p->socket << 20) | p->core;
+  case BIND_SCATTER:
+    return ((long)p->smt << 40) | ((long)core_rank(p) << 20) | p->socket;
+  default:
+    return ((long)p->socket << 40) | ((long)p->core << 20) | p->smt;
+  }
+}
+
+static int by_key(const void *a, const void *b){
+
+  long ka = sort_key(&cpus[*(int *)a]);
+  long kb = sort_key(&cpus[*(int *)b]);
+
+  return (ka > kb) - (ka < kb);
+}
+
+static int find_cpu(int c){
+
+  int i;
+
+  for (i = 0; i < ncpus; i++) {
+    if (cpus[i].cpu == c) return i;
+  }
+
+  return -1;
+}
+
+/* expand a list such as 0,2,4-7 into order[] */
+static int parse_list(){
+
+  char *copy = strdup(bind_list), *tok;
+  int lo, hi, c, i;
+
+  if (!copy) return 1;
+  order = (int *)malloc(CPU_SETSIZE * sizeof(int));
+  if (!order) { free(copy); return 1; }
+
+  for (tok = strtok(copy, ","); tok; tok = strtok(NULL, ",")) {
+    if (sscanf(tok, "%d-%d", &lo, &hi) != 2) hi = lo = atoi(tok);
+    for (c = lo; c <= hi && norder < CPU_SETSIZE; c++) {
+      i = find_cpu(c);
+      if (i < 0) {
+        fprintf(stderr, "ERROR: CPU %d in --bind is not available to this process\n", c);
+        free(copy);
+        return 1;
+      }
+      order[norder++] = i;
+    }
+  }
+
+  free(copy);
+  return norder == 0;
+}
+
+static int build_order(){
+
+  int i;
+
+  if (load_topology()) return 1;
+  if (affinity_bind == BIND_LIST) return parse_list();
+
+  order = (int *)malloc(ncpus * sizeof(int));
+  if (!order) return 1;
+  for (i = 0; i < ncpus; i++) order[i] = i;
+  norder = ncpus;
+  qsort(order, norder, sizeof(int), by_key);
+
+  return 0;
+}
+
+/* pin the threads of the next parallel region and record where they run */
+void affinity_apply(){
+
+  int nthreads = omp_get_max_threads();
+  int failed = 0, unbound = 0, t, i;
+  cpu_place_t *p;
+
+  if (!cpus && build_order()) {
+    fprintf(stderr, "ERROR: unable to set up --bind %s, threads are not pinned\n", affinity_name);
+    affinity_bind = BIND_NONE;
+    affinity_name = "none";
+  }
+
+  p = (cpu_place_t *)realloc(placement, nthreads * sizeof(cpu_place_t));
+  if (!p) return;
+  placement = p;
+  placement_n = nthreads;
+
+  if (affinity_bind != BIND_NONE && nthreads > norder) {
+    printf("Warning: %d threads share %d CPUs for --bind %s.\n", nthreads, norder, affinity_name);
+  }
+
+# pragma omp parallel private(t, i) reduction(+:failed, unbound)
+  {
+    cpu_set_t set;
+
+    t = omp_get_thread_num();
+    if (affinity_bind != BIND_NONE) {
+      CPU_ZERO(&set);
+      CPU_SET(cpus[order[t % norder]].cpu, &set);
+      if (sched_setaffinity(0, sizeof(set), &set) != 0) failed++;
+    }
+    if (sched_getaffinity(0, sizeof(set), &set) == 0 && CPU_COUNT(&set) > 1) unbound++;
+
+    i = find_cpu(sched_getcpu());
+    if (i >= 0) placement[t] = cpus[i];
+    else {
+      placement[t].cpu = sched_getcpu();
+      placement[t].socket = placement[t].core = placement[t].smt = -1;
+    }
+  }
+
+  if (failed) fprintf(stderr, "ERROR: sched_setaffinity failed for %d threads\n", failed);
+
+  printf("Thread placement (--bind %s", affinity_name);
+  if (affinity_bind == BIND_NONE) {
+    if (ncpus == 1) printf(", one CPU available)");
+    else printf(", %s)", unbound ? "not pinned, threads may migrate" : "pinned by OMP_PROC_BIND/OMP_PLACES");
+  }
+  else printf(")");
+  printf(":\n");
+  for (t = 0; t < placement_n; t++) {
+    printf("  thread %3d -> cpu %3d  socket %d  core %3d  smt %d\n", t, placement[t].cpu,
+           placement[t].socket, placement[t].core, placement[t].smt);
+  }
+}
+
+#else
+
+int affinity_select(char *b){
+  if (strcmp(b, "none") != 0) {
+    fprintf(stderr, "ERROR: thread binding is only supported on Linux\n");
+    return 1;
+  }
+  return 0;
+}
+
+void affinity_apply(){
+  placement_n = 0;
+}
+
+#endif
+
+int affinity_threads(){
+  return placement_n;
+}
+
+cpu_place_t *affinity_thread(int t){
+  return &placement[t];
+}
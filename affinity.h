@@ -0,0 +1,56 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+/*
+ * Thread placement. --bind pins every OpenMP thread to one logical CPU
+ * with sched_setaffinity, walking the CPUs the process may run on in one
+ * of these orders:
+ *   compact  fill the SMT siblings of a core, then the cores of a socket
+ *   cores    one thread per physical core first, SMT siblings after
+ *   scatter  round-robin over sockets
+ *   LIST     explicit CPU list, e.g. 0,2,4-7
+ * With the default "none" threads are left alone (so OMP_PLACES and
+ * OMP_PROC_BIND apply) and the placement is only checked. In every case
+ * the CPU, socket, core and SMT index of each thread is printed and
+ * recorded with the results.
+ */
+
+#define BIND_NONE    0
+#define BIND_COMPACT 1
+#define BIND_CORES   2
+#define BIND_SCATTER 3
+#define BIND_LIST    4
+
+typedef struct {
+  int cpu, socket, core, smt;
+} cpu_place_t;
+
+extern int affinity_bind;
+extern char *affinity_name;
+
+int affinity_select(char *);
+void affinity_apply();
+int affinity_threads();
+cpu_place_t *affinity_thread(int);
+
+#endif
@@ -0,0 +1,329 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "level0.h"
+#include "utils.h"
+#include "stats.h"
+#include "rng.h"
+
+/* blocks every thread keeps alive, so frees do not simply undo the last malloc */
+#define ALLOC_LIVE 256
+/* sizes drawn per thread before timing and cycled through */
+#define ALLOC_NSIZES 4096
+/* entries of the queue from a producer to its consumer */
+#define ALLOC_QUEUE 1024
+/* keeps the indexes of a queue on lines of their own */
+#define ALLOC_LINE 128
+
+#define ALLOC_MALLOC  0
+#define ALLOC_CALLOC  1
+#define ALLOC_ALIGNED 2
+#define ALLOC_CROSS   3
+#define ALLOC_NOPS    4
+static char *alloc_ops[ALLOC_NOPS] = {"malloc", "calloc", "aligned_alloc", "cross_thread"};
+
+#define DIST_FIXED    0
+#define DIST_POWERLAW 1
+#define DIST_MIXED    2
+#define DIST_N        3
+static char *dist_names[DIST_N] = {"fixed", "power-law", "mixed"};
+
+/* blocks handed from a producer thread to the consumer thread next to it */
+typedef struct {
+  void *slot[ALLOC_QUEUE];
+  unsigned long head __attribute__((aligned(ALLOC_LINE)));  /* written by the producer */
+  unsigned long tail __attribute__((aligned(ALLOC_LINE)));  /* written by the consumer */
+} alloc_queue_t;
+
+/* resident set size of the process in bytes, or -1 if unknown */
+static double alloc_rss(){
+
+  double rss = -1;
+#ifdef __linux__
+  unsigned long size, resident;
+  FILE *f = fopen("/proc/self/statm", "r");
+
+  if (f) {
+    if (fscanf(f, "%lu %lu", &size, &resident) == 2) rss = (double)resident * sysconf(_SC_PAGESIZE);
+    fclose(f);
+  }
+#endif
+
+  return rss;
+}
+
+/*
+ * Draw the sizes of one thread: every allocation 'fixed' bytes, a
+ * power law with the probability of a size proportional to its inverse
+ * from 16 bytes to 64 KB, or mostly small blocks of 16 to 256 bytes with
+ * one in twenty large blocks of 64 KB to 1 MB, above the mmap threshold
+ * of most allocators.
+ */
+static void alloc_sizes(size_t *sizes, int dist, size_t fixed, rng_t *rng){
+
+  size_t i, b;
+
+  for (i = 0; i < ALLOC_NSIZES; i++) {
+    switch (dist) {
+    case DIST_POWERLAW:
+      b = (size_t)16 << rng_below(rng, 12);
+      sizes[i] = b + rng_below(rng, b);
+      break;
+    case DIST_MIXED:
+      if (rng_below(rng, 20) == 0) sizes[i] = 65536 + rng_below(rng, 983041);
+      else sizes[i] = 16 + rng_below(rng, 241);
+      break;
+    default:
+      sizes[i] = fixed;
+      break;
+    }
+  }
+}
+
+/* one allocation by operation op, with its first byte written so it cannot be elided */
+static inline char *alloc_one(int op, size_t size){
+
+  char *p;
+
+  switch (op) {
+  case ALLOC_CALLOC:
+    p = (char *)calloc(1, size);
+    break;
+  case ALLOC_ALIGNED:
+    p = (char *)aligned_alloc(64, (size + 63) & ~(size_t)63);
+    break;
+  default:
+    p = (char *)malloc(size);
+    break;
+  }
+  if (p) p[0] = (char)size;
+
+  return p;
+}
+
+/* free the per-thread size and block lists */
+static void alloc_free_lists(size_t **sizes, char ***live, int nthreads){
+
+  int t;
+
+  for (t = 0; t < nthreads; t++) {
+    if (sizes) free(sizes[t]);
+    if (live) free(live[t]);
+  }
+  free(sizes);
+  free(live);
+}
+
+/*
+ * Allocator throughput. For malloc, calloc and aligned_alloc every thread
+ * keeps ALLOC_LIVE blocks alive and replaces one of them per operation,
+ * a free followed by an allocation. For cross_thread, even threads
+ * allocate blocks with malloc and pass them through a queue to the next
+ * thread, which frees them, as in a producer-consumer pipeline. The live
+ * blocks are allocated before and freed after the timed samples. Every
+ * operation runs with fixed, power-law and mixed sizes and reports the
+ * malloc/free pairs per second and the growth of the resident set.
+ */
+int alloc_bench(char *o, unsigned int s, unsigned long reps){
+
+  int op, first, last, dist, k = 0, nfail = 0;
+  int have_rss = alloc_rss() >= 0;
+  double rate[ALLOC_NOPS * DIST_N], growth[ALLOC_NOPS * DIST_N], rss, ops;
+  unsigned long steps;
+  char title[128], buf[32];
+  alloc_queue_t *queues = NULL;
+
+  sampler_t smp;
+
+  int nthreads;
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  for (op = 0; op < ALLOC_NOPS; op++) {
+    if (strcmp(o, alloc_ops[op]) == 0) break;
+  }
+  if (op < ALLOC_NOPS) first = last = op;
+  else if (strcmp(o, "all") == 0) {
+    first = 0;
+    last = ALLOC_NOPS - 1;
+  }
+  else {
+    fprintf(stderr, "ERROR: check you are using a valid operation type...\n");
+    return 0;
+  }
+  if (s == 0) {
+    fprintf(stderr, "ERROR: the fixed allocation size must not be zero...\n");
+    return 0;
+  }
+
+  size_t **sizes = (size_t **)calloc(nthreads, sizeof(size_t *));
+  char ***live = (char ***)calloc(nthreads, sizeof(char **));
+  if (!sizes || !live) {
+    printf("Out Of Memory: could not allocate space for the sizes.\n");
+    free(sizes);
+    free(live);
+    return 0;
+  }
+  # pragma omp parallel reduction(+:nfail)
+  {
+      int t = omp_get_thread_num();
+      sizes[t] = (size_t *)malloc(ALLOC_NSIZES * sizeof(size_t));
+      live[t] = (char **)calloc(ALLOC_LIVE, sizeof(char *));
+      if (!sizes[t] || !live[t]) nfail++;
+  }
+  if (nfail) {
+    printf("Out Of Memory: could not allocate space for the sizes.\n");
+    alloc_free_lists(sizes, live, nthreads);
+    return 0;
+  }
+
+  for (op = first; op <= last; op++) {
+
+    if (op == ALLOC_CROSS && nthreads < 2) {
+      fprintf(stderr, "ERROR: cross_thread needs at least two threads...\n");
+      continue;
+    }
+    if (op == ALLOC_CROSS && !queues) {
+      queues = (alloc_queue_t *)aligned_alloc(ALLOC_LINE, (nthreads / 2) * sizeof(alloc_queue_t));
+      if (!queues) {
+        printf("Out Of Memory: could not allocate space for the queues.\n");
+        alloc_free_lists(sizes, live, nthreads);
+        return 0;
+      }
+    }
+
+    for (dist = 0; dist < DIST_N; dist++, k++) {
+
+      if (dist == DIST_FIXED) sprintf(title, "Allocator %s, fixed %s", alloc_ops[op], format_bytes(buf, s));
+      else sprintf(title, "Allocator %s, %s sizes", alloc_ops[op], dist_names[dist]);
+
+      # pragma omp parallel
+      alloc_sizes(sizes[omp_get_thread_num()], dist, s, rng_thread());
+
+      rss = alloc_rss();
+      steps = reps;
+      nfail = 0;
+      sampler_init(&smp, title);
+      if (steps == 0) sampler_calibrate(&smp, &steps);
+
+      /* the live blocks and the queues are set up outside the samples */
+      if (op == ALLOC_CROSS) memset(queues, 0, (nthreads / 2) * sizeof(alloc_queue_t));
+      else {
+        # pragma omp parallel
+        {
+            int t = omp_get_thread_num(), j;
+            for (j = 0; j < ALLOC_LIVE; j++) live[t][j] = alloc_one(op, sizes[t][j]);
+        }
+      }
+
+      while(sampler_next(&smp)){
+        # pragma omp parallel reduction(+:nfail)
+        {
+            int t = omp_get_thread_num();
+            size_t *sz = sizes[t];
+            char **blocks = live[t];
+            char *p;
+            unsigned long i, base;
+            int j;
+
+            if (op != ALLOC_CROSS) {
+                sampler_thread_start(&smp);
+                for (i = 0; i < steps; i++) {
+                    j = i % ALLOC_LIVE;
+                    free(blocks[j]);
+                    blocks[j] = alloc_one(op, sz[i % ALLOC_NSIZES]);
+                }
+                sampler_thread_stop(&smp);
+            }
+            else {
+                /* an odd thread out has no partner and stays idle; the */
+                /* queue is empty between samples, so both sides carry */
+                /* on from the count moved so far                       */
+                alloc_queue_t *q = &queues[t / 2];
+                base = (t / 2 < nthreads / 2) ? q->head : 0;
+                sampler_thread_start(&smp);
+                if (t / 2 < nthreads / 2 && t % 2 == 0) {
+                    for (i = base; i < base + steps; i++) {
+                        p = alloc_one(ALLOC_MALLOC, sz[i % ALLOC_NSIZES]);
+                        while (i - __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE) == ALLOC_QUEUE) ;
+                        q->slot[i % ALLOC_QUEUE] = p;
+                        __atomic_store_n(&q->head, i + 1, __ATOMIC_RELEASE);
+                    }
+                }
+                else if (t / 2 < nthreads / 2) {
+                    for (i = base; i < base + steps; i++) {
+                        while (__atomic_load_n(&q->head, __ATOMIC_ACQUIRE) == i) ;
+                        p = (char *)q->slot[i % ALLOC_QUEUE];
+                        if (!p) nfail++;
+                        free(p);
+                        __atomic_store_n(&q->tail, i + 1, __ATOMIC_RELEASE);
+                    }
+                }
+                sampler_thread_stop(&smp);
+            }
+        }
+      }
+      /* every pair moves steps blocks, every other thread replaces steps blocks */
+      ops = (double)steps * ((op == ALLOC_CROSS) ? nthreads / 2 : nthreads);
+      sampler_set_work(&smp, ops, 0.0);
+      rate[k] = ops / sampler_report(&smp);
+
+      if (op != ALLOC_CROSS) {
+        # pragma omp parallel reduction(+:nfail)
+        {
+            int t = omp_get_thread_num(), j;
+            for (j = 0; j < ALLOC_LIVE; j++) {
+                if (!live[t][j]) nfail++;
+                free(live[t][j]);
+            }
+        }
+      }
+      growth[k] = alloc_rss() - rss;
+
+      if (nfail) printf("Warning: %d allocations failed.\n", nfail);
+    }
+  }
+
+  printf("\nmalloc/free pairs per second with %d threads:\n", nthreads);
+  printf("  %-14s  %-10s  %14s  %14s  %14s\n", "operation", "sizes", "total ops/s", "ops/s/thread", "RSS growth");
+  for (op = first, k = 0; op <= last; op++) {
+    for (dist = 0; dist < DIST_N; dist++, k++) {
+      if (op == ALLOC_CROSS && nthreads < 2) continue;
+      printf("  %-14s  %-10s  %14.6e  %14.6e", alloc_ops[op], dist_names[dist], rate[k], rate[k] / nthreads);
+      if (have_rss) printf("  %11.2f MB\n", growth[k] / 1048576.0);
+      else printf("  %14s\n", "n/a");
+    }
+  }
+  printf("\n");
+
+  alloc_free_lists(sizes, live, nthreads);
+  free(queues);
+
+  return 0;
+}
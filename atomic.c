@@ -0,0 +1,223 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#include "level0.h"
+#include "utils.h"
+#include "stats.h"
+
+/* spacing of the counters, two cache lines so adjacent-line prefetch does not pair them */
+#define ATOMIC_LINE 128
+
+/*
+ * One kernel per operation and data type: n atomic updates of *p.
+ * Values read back are summed, in an unsigned long that may wrap, and
+ * added to *sink so they are not optimised away;
+ * the return value is the number of failed compare-and-swap attempts.
+ */
+typedef unsigned long (*atomic_kernel_t)(void *, unsigned long, double *);
+
+#define ATOMIC_FETCH_ADD(T, NAME)                                       \
+static unsigned long NAME##_fetch_add(void *vp, unsigned long n, double *sink){ \
+  T *p = (T *)vp;                                                       \
+  unsigned long i, sum = 0;                                             \
+  for (i = 0; i < n; i++) sum += (unsigned long)__atomic_fetch_add(p, 1, __ATOMIC_SEQ_CST); \
+  *sink += (double)sum;                                                 \
+  return 0;                                                             \
+}
+
+#define ATOMIC_KERNELS(T, NAME)                                         \
+static unsigned long NAME##_cas(void *vp, unsigned long n, double *sink){ \
+  T *p = (T *)vp, old = 0, new;                                         \
+  unsigned long i, fails = 0;                                           \
+  for (i = 0; i < n; i++) {                                             \
+    __atomic_load(p, &old, __ATOMIC_RELAXED);                           \
+    while (1) {                                                         \
+      new = old + 1;                                                    \
+      if (__atomic_compare_exchange(p, &old, &new, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) break; \
+      fails++;                                                          \
+    }                                                                   \
+  }                                                                     \
+  *sink += (double)old;                                                 \
+  return fails;                                                         \
+}                                                                       \
+static unsigned long NAME##_exchange(void *vp, unsigned long n, double *sink){ \
+  T *p = (T *)vp, v, ret;                                               \
+  unsigned long i, sum = 0;                                             \
+  for (i = 0; i < n; i++) {                                             \
+    v = (T)i;                                                           \
+    __atomic_exchange(p, &v, &ret, __ATOMIC_SEQ_CST);                   \
+    sum += (unsigned long)ret;                                          \
+  }                                                                     \
+  *sink += (double)sum;                                                 \
+  return 0;                                                             \
+}                                                                       \
+static unsigned long NAME##_omp_atomic(void *vp, unsigned long n, double *sink){ \
+  T *p = (T *)vp;                                                       \
+  unsigned long i;                                                      \
+  for (i = 0; i < n; i++) {                                             \
+    _Pragma("omp atomic")                                               \
+    *p += 1;                                                            \
+  }                                                                     \
+  *sink += 0.0;                                                         \
+  return 0;                                                             \
+}                                                                       \
+static unsigned long NAME##_omp_capture(void *vp, unsigned long n, double *sink){ \
+  T *p = (T *)vp, v;                                                    \
+  unsigned long i, sum = 0;                                             \
+  for (i = 0; i < n; i++) {                                             \
+    _Pragma("omp atomic capture")                                       \
+    v = (*p)++;                                                         \
+    sum += (unsigned long)v;                                            \
+  }                                                                     \
+  *sink += (double)sum;                                                 \
+  return 0;                                                             \
+}
+
+ATOMIC_FETCH_ADD(int, int)
+ATOMIC_FETCH_ADD(long, long)
+ATOMIC_KERNELS(int, int)
+ATOMIC_KERNELS(long, long)
+ATOMIC_KERNELS(double, double)
+
+/* kernels for int, long and double; there is no atomic add for doubles, */
+/* so their fetch-add is the compare-and-swap loop compilers emit for it */
+typedef struct {
+  char *name;
+  atomic_kernel_t kernel[3];
+} atomic_op_t;
+
+#define ATOMIC_NOPS 5
+static atomic_op_t atomic_ops[ATOMIC_NOPS] = {
+  {"fetch_add",          {int_fetch_add,   long_fetch_add,   double_cas}},
+  {"cas",                {int_cas,         long_cas,         double_cas}},
+  {"exchange",           {int_exchange,    long_exchange,    double_exchange}},
+  {"omp_atomic",         {int_omp_atomic,  long_omp_atomic,  double_omp_atomic}},
+  {"omp_atomic_capture", {int_omp_capture, long_omp_capture, double_omp_capture}}
+};
+
+/* contention cases: one line per thread, powers of two below that, one line */
+#define ATOMIC_MAXK 34
+
+/*
+ * Run atomic operation 'o' (or all of them) on data type 'dt' with the
+ * threads spread over k counters, each on its own line: k equal to the
+ * number of threads is uncontended, k = 1 has every thread on one line,
+ * and the powers of two in between share every line among several
+ * threads. Reports the operations per second of every case.
+ */
+int atomic_bench(char *o, char *dt, unsigned long reps){
+
+  int nk = 0, k, j, op, type;
+  int lines[ATOMIC_MAXK];
+  double rate[ATOMIC_MAXK], fails[ATOMIC_MAXK];
+  unsigned long steps;
+  char *raw, *base;
+  char title[128], scenario[64];
+  double sink = 0.0;
+
+  sampler_t smp;
+
+  int nthreads;
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  if (strcmp(dt, "int") == 0) type = 0;
+  else if (strcmp(dt, "long") == 0) type = 1;
+  else if (strcmp(dt, "double") == 0) type = 2;
+  else {
+    fprintf(stderr, "ERROR: check you are using a valid data type (int, long or double)...\n");
+    return 0;
+  }
+
+  for (op = 0; op < ATOMIC_NOPS; op++) {
+    if (strcmp(o, atomic_ops[op].name) == 0) break;
+  }
+  if (op == ATOMIC_NOPS && strcmp(o, "all") != 0) {
+    fprintf(stderr, "ERROR: check you are using a valid operation type...\n");
+    return 0;
+  }
+
+  lines[nk++] = nthreads;
+  for (k = 1; 2 * k < nthreads; k *= 2) ;
+  for (; k > 1; k /= 2) lines[nk++] = k;
+  if (nthreads > 1) lines[nk++] = 1;
+
+  raw = (char *)malloc(nthreads * ATOMIC_LINE + ATOMIC_LINE);
+  if (!raw) {
+    printf("Out Of Memory: could not allocate space for the counters.\n");
+    return 0;
+  }
+  base = raw + (ATOMIC_LINE - (size_t)raw % ATOMIC_LINE) % ATOMIC_LINE;
+
+  for (op = (op == ATOMIC_NOPS) ? 0 : op; op < ATOMIC_NOPS; op++) {
+
+    atomic_kernel_t kernel = atomic_ops[op].kernel[type];
+
+    for (j = 0; j < nk; j++) {
+
+      k = lines[j];
+      if (k == nthreads) sprintf(scenario, "uncontended, a line per thread");
+      else if (k == 1) sprintf(scenario, "contended, one shared line");
+      else sprintf(scenario, "%d lines, %d threads per line", k, (nthreads + k - 1) / k);
+      sprintf(title, "Atomic %s, %s, %s", atomic_ops[op].name, dt, scenario);
+
+      steps = reps;
+      fails[j] = 0.0;
+      sampler_init(&smp, title);
+      if (steps == 0) sampler_calibrate(&smp, &steps);
+      while(sampler_next(&smp)){
+        double nfail = 0.0;
+        memset(base, 0, nthreads * ATOMIC_LINE);
+        # pragma omp parallel reduction(+:sink, nfail)
+        {
+            void *p = base + (omp_get_thread_num() % k) * ATOMIC_LINE;
+            sampler_thread_start(&smp);
+            nfail += (double)kernel(p, steps, &sink);
+            sampler_thread_stop(&smp);
+        }
+        fails[j] = nfail;
+      }
+      sampler_set_work(&smp, (double)steps * nthreads, 0.0);
+      rate[j] = (double)steps * nthreads / sampler_report(&smp);
+      fails[j] /= (double)steps * nthreads;
+    }
+
+    printf("\nAtomic %s on %s with %d threads:\n", atomic_ops[op].name, dt, nthreads);
+    printf("  %6s  %14s  %14s  %12s  %12s\n", "lines", "total ops/s", "ops/s/thread", "vs 1/thread", "CAS fails/op");
+    for (j = 0; j < nk; j++) {
+      printf("  %6d  %14.6e  %14.6e  %12.3f  %12.3f\n", lines[j], rate[j], rate[j] / nthreads,
+             rate[0] > 0.0 ? rate[j] / rate[0] : 0.0, fails[j]);
+    }
+    printf("\n");
+
+    if (strcmp(o, "all") != 0) break;
+  }
+
+  printf("Keep result: %f\n\n", sink);
+
+  free(raw);
+
+  return 0;
+}
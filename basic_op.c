@@ -26,11 +26,27 @@
 
 #include "level0.h"
 #include "utils.h"
+#include "stats.h"
 
+/*
+ * The results of the loops below are never used, so an optimising
+ * compiler would fold the chains, hoist them out of the loops or drop
+ * them and time an empty region. KEEP_INT and KEEP_FP make the operands
+ * opaque after every operation; they emit no instructions themselves.
+ */
+#if defined(__x86_64__)
+#define KEEP_FP_REG "+x"
+#elif defined(__aarch64__)
+#define KEEP_FP_REG "+w"
+#else
+#define KEEP_FP_REG "+g"
+#endif
+#define KEEP_INT(a,b,c,d) __asm__ __volatile__ ("" : "+r" (a), "+r" (b), "+r" (c), "+r" (d))
+#define KEEP_FP(a,b,c,d) __asm__ __volatile__ ("" : KEEP_FP_REG (a), KEEP_FP_REG (b), KEEP_FP_REG (c), KEEP_FP_REG (d))
 
 int int_basic_op(char *opType, unsigned long reps){
   
-  int i;
+  unsigned long i;
   
 #ifdef ONEVOL
   unsigned int a, b, c;
@@ -54,15 +70,14 @@ int int_basic_op(char *opType, unsigned long reps){
   c = rand();
   d = rand();
   
-  struct timespec start, end;
+  sampler_t smp;
   
-  /* warm-up loop with nop */
+  /* measure loop on its own with nop, calibrating reps if not given */
+  reps = loop_timer_nop(reps);
   
+  /* warm-up loop with nop, over the calibrated count */
   warmup_loop(reps);
   
-  /* measure loop on its own with nop */
-  loop_timer_nop(reps);
-  
   /* measure loop on its own */
   loop_timer(reps);
   
@@ -74,90 +89,123 @@ int int_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) c = a+b;
       
       /* main loops */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Addition - 1 op HR");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) c = a+d;
-      clock_gettime(CLOCK, &end);
-      elapsed_time_hr(start, end, "Integer Addition - 1 op HR");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Addition - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_INT(a,b,c,d);
+            b = d+c; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Addition - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Addition - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_INT(a,b,c,d);
+            b = d+c; KEEP_INT(a,b,c,d);
+            a = b+d; KEEP_INT(a,b,c,d);
+            c = d+a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Addition - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Addition - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
-        b = c+d;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_INT(a,b,c,d);
+            b = d+c; KEEP_INT(a,b,c,d);
+            a = b+d; KEEP_INT(a,b,c,d);
+            c = d+a; KEEP_INT(a,b,c,d);
+            b = c+d; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Addition - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
-        b = c+d;
-        c = d+b;
-        a = d+c;
-        b = a+d;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Addition - 8 ops");
+      sampler_init(&smp, "Integer Addition - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_INT(a,b,c,d);
+            b = d+c; KEEP_INT(a,b,c,d);
+            a = b+d; KEEP_INT(a,b,c,d);
+            c = d+a; KEEP_INT(a,b,c,d);
+            b = c+d; KEEP_INT(a,b,c,d);
+            c = d+b; KEEP_INT(a,b,c,d);
+            a = d+c; KEEP_INT(a,b,c,d);
+            b = a+d; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
-        b = c+d;
-        c = d+b;
-        a = d+c;
-        b = a+d;
-        c = b+d;
-        b = c+d;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Addition - 10 ops");
+      sampler_init(&smp, "Integer Addition - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_INT(a,b,c,d);
+            b = d+c; KEEP_INT(a,b,c,d);
+            a = b+d; KEEP_INT(a,b,c,d);
+            c = d+a; KEEP_INT(a,b,c,d);
+            b = c+d; KEEP_INT(a,b,c,d);
+            c = d+b; KEEP_INT(a,b,c,d);
+            a = d+c; KEEP_INT(a,b,c,d);
+            b = a+d; KEEP_INT(a,b,c,d);
+            c = b+d; KEEP_INT(a,b,c,d);
+            b = c+d; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -167,91 +215,123 @@ int int_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) c = a-b;
       
       /* main loop */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Subtraction - 1 op");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) c = a-b;
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Subtraction - 1 op");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Subtraction - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_INT(a,b,c,d);
+            a = b-c; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Subtraction - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Subtraction - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_INT(a,b,c,d);
+            a = b-c; KEEP_INT(a,b,c,d);
+            b = a-c; KEEP_INT(a,b,c,d);
+            c = c-a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Subtraction - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Subtraction - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
-        b = b-a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_INT(a,b,c,d);
+            a = b-c; KEEP_INT(a,b,c,d);
+            b = a-c; KEEP_INT(a,b,c,d);
+            c = c-a; KEEP_INT(a,b,c,d);
+            b = b-a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Subtraction - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
-        b = b-a;
-        c = c-b;
-        a = a-c;
-        b = b-c;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Subtraction - 8 ops");
+      sampler_init(&smp, "Integer Subtraction - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_INT(a,b,c,d);
+            a = b-c; KEEP_INT(a,b,c,d);
+            b = a-c; KEEP_INT(a,b,c,d);
+            c = c-a; KEEP_INT(a,b,c,d);
+            b = b-a; KEEP_INT(a,b,c,d);
+            c = c-b; KEEP_INT(a,b,c,d);
+            a = a-c; KEEP_INT(a,b,c,d);
+            b = b-c; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
-        b = b-a;
-        c = c-b;
-        a = a-c;
-        b = b-c;
-        c = b-a;
-        b = c-a;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Subtraction - 10 ops");
+      sampler_init(&smp, "Integer Subtraction - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_INT(a,b,c,d);
+            a = b-c; KEEP_INT(a,b,c,d);
+            b = a-c; KEEP_INT(a,b,c,d);
+            c = c-a; KEEP_INT(a,b,c,d);
+            b = b-a; KEEP_INT(a,b,c,d);
+            c = c-b; KEEP_INT(a,b,c,d);
+            a = a-c; KEEP_INT(a,b,c,d);
+            b = b-c; KEEP_INT(a,b,c,d);
+            c = b-a; KEEP_INT(a,b,c,d);
+            b = c-a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -261,91 +341,123 @@ int int_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) c = a*b;
       
       /* main loop */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Multiplication - 1 op");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) c = a*b;
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Multiplication - 1 op");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Multiplication - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_INT(a,b,c,d);
+            a = b*c; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Multiplication - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Multiplication - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_INT(a,b,c,d);
+            a = b*c; KEEP_INT(a,b,c,d);
+            b = a*c; KEEP_INT(a,b,c,d);
+            c = c*a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Multiplication - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Multiplication - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
-        b = b*a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_INT(a,b,c,d);
+            a = b*c; KEEP_INT(a,b,c,d);
+            b = a*c; KEEP_INT(a,b,c,d);
+            c = c*a; KEEP_INT(a,b,c,d);
+            b = b*a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Multiplication - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
-        b = b*a;
-        c = c*b;
-        a = a*c;
-        b = b*c;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Multiplication - 8 ops");
+      sampler_init(&smp, "Integer Multiplication - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_INT(a,b,c,d);
+            a = b*c; KEEP_INT(a,b,c,d);
+            b = a*c; KEEP_INT(a,b,c,d);
+            c = c*a; KEEP_INT(a,b,c,d);
+            b = b*a; KEEP_INT(a,b,c,d);
+            c = c*b; KEEP_INT(a,b,c,d);
+            a = a*c; KEEP_INT(a,b,c,d);
+            b = b*c; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
-        b = b*a;
-        c = c*b;
-        a = a*c;
-        b = b*c;
-        c = b*a;
-        b = c*a;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Multiplication - 10 ops");
+      sampler_init(&smp, "Integer Multiplication - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_INT(a,b,c,d);
+            a = b*c; KEEP_INT(a,b,c,d);
+            b = a*c; KEEP_INT(a,b,c,d);
+            c = c*a; KEEP_INT(a,b,c,d);
+            b = b*a; KEEP_INT(a,b,c,d);
+            c = c*b; KEEP_INT(a,b,c,d);
+            a = a*c; KEEP_INT(a,b,c,d);
+            b = b*c; KEEP_INT(a,b,c,d);
+            c = b*a; KEEP_INT(a,b,c,d);
+            b = c*a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -360,91 +472,123 @@ int int_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) r1 = a/b;
       
       /* main loop */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Division - 1 op");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) r1 = a/b;
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Division - 1 op");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Division - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_INT(a,b,c,d);
+            r2 = b/c; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Division - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Division - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_INT(a,b,c,d);
+            r2 = b/c; KEEP_INT(a,b,c,d);
+            r3 = a/c; KEEP_INT(a,b,c,d);
+            r4 = b/a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Division - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Integer Division - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
-        r5 = c/a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_INT(a,b,c,d);
+            r2 = b/c; KEEP_INT(a,b,c,d);
+            r3 = a/c; KEEP_INT(a,b,c,d);
+            r4 = b/a; KEEP_INT(a,b,c,d);
+            r5 = c/a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Division - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
-        r5 = c/a;
-        r6 = c/b;
-        r7 = a/a;
-        r8 = b/b;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Division - 8 ops");
+      sampler_init(&smp, "Integer Division - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_INT(a,b,c,d);
+            r2 = b/c; KEEP_INT(a,b,c,d);
+            r3 = a/c; KEEP_INT(a,b,c,d);
+            r4 = b/a; KEEP_INT(a,b,c,d);
+            r5 = c/a; KEEP_INT(a,b,c,d);
+            r6 = c/b; KEEP_INT(a,b,c,d);
+            r7 = a/a; KEEP_INT(a,b,c,d);
+            r8 = b/b; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
-        r5 = c/a;
-        r6 = c/b;
-        r7 = a/a;
-        r8 = b/b;
-        r9 = c/c;
-        r10 = r10/a;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Division - 10 ops");
+      sampler_init(&smp, "Integer Division - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_INT(a,b,c,d);
+            r2 = b/c; KEEP_INT(a,b,c,d);
+            r3 = a/c; KEEP_INT(a,b,c,d);
+            r4 = b/a; KEEP_INT(a,b,c,d);
+            r5 = c/a; KEEP_INT(a,b,c,d);
+            r6 = c/b; KEEP_INT(a,b,c,d);
+            r7 = a/a; KEEP_INT(a,b,c,d);
+            r8 = b/b; KEEP_INT(a,b,c,d);
+            r9 = c/c; KEEP_INT(a,b,c,d);
+            r10 = r10/a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -458,7 +602,7 @@ int int_basic_op(char *opType, unsigned long reps){
 
 int float_basic_op(char *opType, unsigned long reps){
   
-  int i;
+  unsigned long i;
   
 #ifdef ONEVOL
   float a, b, c;
@@ -482,13 +626,13 @@ int float_basic_op(char *opType, unsigned long reps){
   c = rand();
   d = rand();
   
-  struct timespec start, end;
+  sampler_t smp;
   
-  /* warm-up loop with nop */
-  warmup_loop(reps);
+  /* measure loop on its own with nop, calibrating reps if not given */
+  reps = loop_timer_nop(reps);
   
-  /* measure loop on its own with nop */
-  loop_timer_nop(reps);
+  /* warm-up loop with nop, over the calibrated count */
+  warmup_loop(reps);
   
   /* measure loop on its own */
   loop_timer(reps);
@@ -501,90 +645,123 @@ int float_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) c = a+b;
       
       /* main loops */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Addition - 1 op HR");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) c = a+d;
-      clock_gettime(CLOCK, &end);
-      elapsed_time_hr(start, end, "Float Addition - 1 op HR");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Addition - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_FP(a,b,c,d);
+            b = d+c; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Addition - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Addition - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_FP(a,b,c,d);
+            b = d+c; KEEP_FP(a,b,c,d);
+            a = b+d; KEEP_FP(a,b,c,d);
+            c = d+a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Addition - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Addition - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
-        b = c+d;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_FP(a,b,c,d);
+            b = d+c; KEEP_FP(a,b,c,d);
+            a = b+d; KEEP_FP(a,b,c,d);
+            c = d+a; KEEP_FP(a,b,c,d);
+            b = c+d; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Addition - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
-        b = c+d;
-        c = d+b;
-        a = d+c;
-        b = a+d;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Addition - 8 ops");
+      sampler_init(&smp, "Float Addition - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_FP(a,b,c,d);
+            b = d+c; KEEP_FP(a,b,c,d);
+            a = b+d; KEEP_FP(a,b,c,d);
+            c = d+a; KEEP_FP(a,b,c,d);
+            b = c+d; KEEP_FP(a,b,c,d);
+            c = d+b; KEEP_FP(a,b,c,d);
+            a = d+c; KEEP_FP(a,b,c,d);
+            b = a+d; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
-        b = c+d;
-        c = d+b;
-        a = d+c;
-        b = a+d;
-        c = b+d;
-        b = c+d;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Addition - 10 ops");
+      sampler_init(&smp, "Float Addition - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_FP(a,b,c,d);
+            b = d+c; KEEP_FP(a,b,c,d);
+            a = b+d; KEEP_FP(a,b,c,d);
+            c = d+a; KEEP_FP(a,b,c,d);
+            b = c+d; KEEP_FP(a,b,c,d);
+            c = d+b; KEEP_FP(a,b,c,d);
+            a = d+c; KEEP_FP(a,b,c,d);
+            b = a+d; KEEP_FP(a,b,c,d);
+            c = b+d; KEEP_FP(a,b,c,d);
+            b = c+d; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -594,91 +771,123 @@ int float_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) c = a-b;
       
       /* main loop */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Subtraction - 1 op");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) c = a-b;
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Subtraction - 1 op");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Subtraction - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_FP(a,b,c,d);
+            a = b-c; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Subtraction - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Subtraction - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_FP(a,b,c,d);
+            a = b-c; KEEP_FP(a,b,c,d);
+            b = a-c; KEEP_FP(a,b,c,d);
+            c = c-a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Subtraction - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Subtraction - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
-        b = b-a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_FP(a,b,c,d);
+            a = b-c; KEEP_FP(a,b,c,d);
+            b = a-c; KEEP_FP(a,b,c,d);
+            c = c-a; KEEP_FP(a,b,c,d);
+            b = b-a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Subtraction - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
-        b = b-a;
-        c = c-b;
-        a = a-c;
-        b = b-c;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Subtraction - 8 ops");
+      sampler_init(&smp, "Integer Subtraction - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_FP(a,b,c,d);
+            a = b-c; KEEP_FP(a,b,c,d);
+            b = a-c; KEEP_FP(a,b,c,d);
+            c = c-a; KEEP_FP(a,b,c,d);
+            b = b-a; KEEP_FP(a,b,c,d);
+            c = c-b; KEEP_FP(a,b,c,d);
+            a = a-c; KEEP_FP(a,b,c,d);
+            b = b-c; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
-        b = b-a;
-        c = c-b;
-        a = a-c;
-        b = b-c;
-        c = b-a;
-        b = c-a;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Subtraction - 10 ops");
+      sampler_init(&smp, "Float Subtraction - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_FP(a,b,c,d);
+            a = b-c; KEEP_FP(a,b,c,d);
+            b = a-c; KEEP_FP(a,b,c,d);
+            c = c-a; KEEP_FP(a,b,c,d);
+            b = b-a; KEEP_FP(a,b,c,d);
+            c = c-b; KEEP_FP(a,b,c,d);
+            a = a-c; KEEP_FP(a,b,c,d);
+            b = b-c; KEEP_FP(a,b,c,d);
+            c = b-a; KEEP_FP(a,b,c,d);
+            b = c-a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -688,91 +897,123 @@ int float_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) c = a*b;
       
       /* main loop */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Multiplication - 1 op");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) c = a*b;
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Multiplication - 1 op");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Multiplication - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_FP(a,b,c,d);
+            a = b*c; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Multiplication - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Multiplication - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_FP(a,b,c,d);
+            a = b*c; KEEP_FP(a,b,c,d);
+            b = a*c; KEEP_FP(a,b,c,d);
+            c = c*a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Multiplication - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Multiplication - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
-        b = b*a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_FP(a,b,c,d);
+            a = b*c; KEEP_FP(a,b,c,d);
+            b = a*c; KEEP_FP(a,b,c,d);
+            c = c*a; KEEP_FP(a,b,c,d);
+            b = b*a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Multiplication - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
-        b = b*a;
-        c = c*b;
-        a = a*c;
-        b = b*c;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Multiplication - 8 ops");
+      sampler_init(&smp, "Float Multiplication - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_FP(a,b,c,d);
+            a = b*c; KEEP_FP(a,b,c,d);
+            b = a*c; KEEP_FP(a,b,c,d);
+            c = c*a; KEEP_FP(a,b,c,d);
+            b = b*a; KEEP_FP(a,b,c,d);
+            c = c*b; KEEP_FP(a,b,c,d);
+            a = a*c; KEEP_FP(a,b,c,d);
+            b = b*c; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
-        b = b*a;
-        c = c*b;
-        a = a*c;
-        b = b*c;
-        c = b*a;
-        b = c*a;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Multiplication - 10 ops");
+      sampler_init(&smp, "Float Multiplication - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_FP(a,b,c,d);
+            a = b*c; KEEP_FP(a,b,c,d);
+            b = a*c; KEEP_FP(a,b,c,d);
+            c = c*a; KEEP_FP(a,b,c,d);
+            b = b*a; KEEP_FP(a,b,c,d);
+            c = c*b; KEEP_FP(a,b,c,d);
+            a = a*c; KEEP_FP(a,b,c,d);
+            b = b*c; KEEP_FP(a,b,c,d);
+            c = b*a; KEEP_FP(a,b,c,d);
+            b = c*a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -787,91 +1028,123 @@ int float_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) r1 = a/b;
       
       /* main loop */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Division - 1 op");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) r1 = a/b;
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Division - 1 op");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Division - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_FP(a,b,c,d);
+            r2 = b/c; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Division - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Division - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_FP(a,b,c,d);
+            r2 = b/c; KEEP_FP(a,b,c,d);
+            r3 = a/c; KEEP_FP(a,b,c,d);
+            r4 = b/a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Division - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Float Division - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
-        r5 = c/a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_FP(a,b,c,d);
+            r2 = b/c; KEEP_FP(a,b,c,d);
+            r3 = a/c; KEEP_FP(a,b,c,d);
+            r4 = b/a; KEEP_FP(a,b,c,d);
+            r5 = c/a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Division - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
-        r5 = c/a;
-        r6 = c/b;
-        r7 = a/a;
-        r8 = b/b;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Division - 8 ops");
+      sampler_init(&smp, "Float Division - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_FP(a,b,c,d);
+            r2 = b/c; KEEP_FP(a,b,c,d);
+            r3 = a/c; KEEP_FP(a,b,c,d);
+            r4 = b/a; KEEP_FP(a,b,c,d);
+            r5 = c/a; KEEP_FP(a,b,c,d);
+            r6 = c/b; KEEP_FP(a,b,c,d);
+            r7 = a/a; KEEP_FP(a,b,c,d);
+            r8 = b/b; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
-        r5 = c/a;
-        r6 = c/b;
-        r7 = a/a;
-        r8 = b/b;
-        r9 = c/c;
-        r10 = r10/a;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Float Division - 10 ops");
+      sampler_init(&smp, "Float Division - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_FP(a,b,c,d);
+            r2 = b/c; KEEP_FP(a,b,c,d);
+            r3 = a/c; KEEP_FP(a,b,c,d);
+            r4 = b/a; KEEP_FP(a,b,c,d);
+            r5 = c/a; KEEP_FP(a,b,c,d);
+            r6 = c/b; KEEP_FP(a,b,c,d);
+            r7 = a/a; KEEP_FP(a,b,c,d);
+            r8 = b/b; KEEP_FP(a,b,c,d);
+            r9 = c/c; KEEP_FP(a,b,c,d);
+            r10 = r10/a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -885,7 +1158,7 @@ int float_basic_op(char *opType, unsigned long reps){
 
 int long_basic_op(char *opType, unsigned long reps){
   
-  int i;
+  unsigned long i;
   
 #ifdef ONEVOL
   long a, b, c;
@@ -909,13 +1182,13 @@ int long_basic_op(char *opType, unsigned long reps){
   c = rand();
   d = rand();
   
-  struct timespec start, end;
+  sampler_t smp;
   
-  /* warm-up loop with nop */
-  warmup_loop(reps);
+  /* measure loop on its own with nop, calibrating reps if not given */
+  reps = loop_timer_nop(reps);
   
-  /* measure loop on its own with nop */
-  loop_timer_nop(reps);
+  /* warm-up loop with nop, over the calibrated count */
+  warmup_loop(reps);
   
   /* measure loop on its own */
   loop_timer(reps);
@@ -928,90 +1201,123 @@ int long_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) c = a+b;
       
       /* main loops */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Addition - 1 op HR");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) c = a+d;
-      clock_gettime(CLOCK, &end);
-      elapsed_time_hr(start, end, "Long Addition - 1 op HR");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Addition - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_INT(a,b,c,d);
+            b = d+c; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Addition - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Addition - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_INT(a,b,c,d);
+            b = d+c; KEEP_INT(a,b,c,d);
+            a = b+d; KEEP_INT(a,b,c,d);
+            c = d+a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Addition - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Addition - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
-        b = c+d;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_INT(a,b,c,d);
+            b = d+c; KEEP_INT(a,b,c,d);
+            a = b+d; KEEP_INT(a,b,c,d);
+            c = d+a; KEEP_INT(a,b,c,d);
+            b = c+d; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Addition - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
-        b = c+d;
-        c = d+b;
-        a = d+c;
-        b = a+d;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Addition - 8 ops");
+      sampler_init(&smp, "Long Addition - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_INT(a,b,c,d);
+            b = d+c; KEEP_INT(a,b,c,d);
+            a = b+d; KEEP_INT(a,b,c,d);
+            c = d+a; KEEP_INT(a,b,c,d);
+            b = c+d; KEEP_INT(a,b,c,d);
+            c = d+b; KEEP_INT(a,b,c,d);
+            a = d+c; KEEP_INT(a,b,c,d);
+            b = a+d; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
-        b = c+d;
-        c = d+b;
-        a = d+c;
-        b = a+d;
-        c = b+d;
-        b = c+d;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Addition - 10 ops");
+      sampler_init(&smp, "Long Addition - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_INT(a,b,c,d);
+            b = d+c; KEEP_INT(a,b,c,d);
+            a = b+d; KEEP_INT(a,b,c,d);
+            c = d+a; KEEP_INT(a,b,c,d);
+            b = c+d; KEEP_INT(a,b,c,d);
+            c = d+b; KEEP_INT(a,b,c,d);
+            a = d+c; KEEP_INT(a,b,c,d);
+            b = a+d; KEEP_INT(a,b,c,d);
+            c = b+d; KEEP_INT(a,b,c,d);
+            b = c+d; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -1021,91 +1327,123 @@ int long_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) c = a-b;
       
       /* main loop */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Subtraction - 1 op");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) c = a-b;
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Subtraction - 1 op");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Subtraction - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_INT(a,b,c,d);
+            a = b-c; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Subtraction - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Subtraction - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_INT(a,b,c,d);
+            a = b-c; KEEP_INT(a,b,c,d);
+            b = a-c; KEEP_INT(a,b,c,d);
+            c = c-a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Subtraction - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Subtraction - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
-        b = b-a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_INT(a,b,c,d);
+            a = b-c; KEEP_INT(a,b,c,d);
+            b = a-c; KEEP_INT(a,b,c,d);
+            c = c-a; KEEP_INT(a,b,c,d);
+            b = b-a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Subtraction - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
-        b = b-a;
-        c = c-b;
-        a = a-c;
-        b = b-c;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Subtraction - 8 ops");
+      sampler_init(&smp, "Integer Subtraction - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_INT(a,b,c,d);
+            a = b-c; KEEP_INT(a,b,c,d);
+            b = a-c; KEEP_INT(a,b,c,d);
+            c = c-a; KEEP_INT(a,b,c,d);
+            b = b-a; KEEP_INT(a,b,c,d);
+            c = c-b; KEEP_INT(a,b,c,d);
+            a = a-c; KEEP_INT(a,b,c,d);
+            b = b-c; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
-        b = b-a;
-        c = c-b;
-        a = a-c;
-        b = b-c;
-        c = b-a;
-        b = c-a;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Subtraction - 10 ops");
+      sampler_init(&smp, "Long Subtraction - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_INT(a,b,c,d);
+            a = b-c; KEEP_INT(a,b,c,d);
+            b = a-c; KEEP_INT(a,b,c,d);
+            c = c-a; KEEP_INT(a,b,c,d);
+            b = b-a; KEEP_INT(a,b,c,d);
+            c = c-b; KEEP_INT(a,b,c,d);
+            a = a-c; KEEP_INT(a,b,c,d);
+            b = b-c; KEEP_INT(a,b,c,d);
+            c = b-a; KEEP_INT(a,b,c,d);
+            b = c-a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -1115,91 +1453,123 @@ int long_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) c = a*b;
       
       /* main loop */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Multiplication - 1 op");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) c = a*b;
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Multiplication - 1 op");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Multiplication - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_INT(a,b,c,d);
+            a = b*c; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Multiplication - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Multiplication - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_INT(a,b,c,d);
+            a = b*c; KEEP_INT(a,b,c,d);
+            b = a*c; KEEP_INT(a,b,c,d);
+            c = c*a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Multiplication - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Multiplication - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
-        b = b*a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_INT(a,b,c,d);
+            a = b*c; KEEP_INT(a,b,c,d);
+            b = a*c; KEEP_INT(a,b,c,d);
+            c = c*a; KEEP_INT(a,b,c,d);
+            b = b*a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Multiplication - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
-        b = b*a;
-        c = c*b;
-        a = a*c;
-        b = b*c;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Multiplication - 8 ops");
+      sampler_init(&smp, "Long Multiplication - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_INT(a,b,c,d);
+            a = b*c; KEEP_INT(a,b,c,d);
+            b = a*c; KEEP_INT(a,b,c,d);
+            c = c*a; KEEP_INT(a,b,c,d);
+            b = b*a; KEEP_INT(a,b,c,d);
+            c = c*b; KEEP_INT(a,b,c,d);
+            a = a*c; KEEP_INT(a,b,c,d);
+            b = b*c; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
-        b = b*a;
-        c = c*b;
-        a = a*c;
-        b = b*c;
-        c = b*a;
-        b = c*a;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Multiplication - 10 ops");
+      sampler_init(&smp, "Long Multiplication - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_INT(a,b,c,d);
+            a = b*c; KEEP_INT(a,b,c,d);
+            b = a*c; KEEP_INT(a,b,c,d);
+            c = c*a; KEEP_INT(a,b,c,d);
+            b = b*a; KEEP_INT(a,b,c,d);
+            c = c*b; KEEP_INT(a,b,c,d);
+            a = a*c; KEEP_INT(a,b,c,d);
+            b = b*c; KEEP_INT(a,b,c,d);
+            c = b*a; KEEP_INT(a,b,c,d);
+            b = c*a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -1214,91 +1584,123 @@ int long_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) r1 = a/b;
       
       /* main loop */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Division - 1 op");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) r1 = a/b;
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Division - 1 op");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Division - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_INT(a,b,c,d);
+            r2 = b/c; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Division - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Division - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_INT(a,b,c,d);
+            r2 = b/c; KEEP_INT(a,b,c,d);
+            r3 = a/c; KEEP_INT(a,b,c,d);
+            r4 = b/a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Division - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Long Division - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
-        r5 = c/a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_INT(a,b,c,d);
+            r2 = b/c; KEEP_INT(a,b,c,d);
+            r3 = a/c; KEEP_INT(a,b,c,d);
+            r4 = b/a; KEEP_INT(a,b,c,d);
+            r5 = c/a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Division - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
-        r5 = c/a;
-        r6 = c/b;
-        r7 = a/a;
-        r8 = b/b;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Division - 8 ops");
+      sampler_init(&smp, "Long Division - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_INT(a,b,c,d);
+            r2 = b/c; KEEP_INT(a,b,c,d);
+            r3 = a/c; KEEP_INT(a,b,c,d);
+            r4 = b/a; KEEP_INT(a,b,c,d);
+            r5 = c/a; KEEP_INT(a,b,c,d);
+            r6 = c/b; KEEP_INT(a,b,c,d);
+            r7 = a/a; KEEP_INT(a,b,c,d);
+            r8 = b/b; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
-        r5 = c/a;
-        r6 = c/b;
-        r7 = a/a;
-        r8 = b/b;
-        r9 = c/c;
-        r10 = r10/a;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Long Division - 10 ops");
+      sampler_init(&smp, "Long Division - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_INT(a,b,c,d);
+            r2 = b/c; KEEP_INT(a,b,c,d);
+            r3 = a/c; KEEP_INT(a,b,c,d);
+            r4 = b/a; KEEP_INT(a,b,c,d);
+            r5 = c/a; KEEP_INT(a,b,c,d);
+            r6 = c/b; KEEP_INT(a,b,c,d);
+            r7 = a/a; KEEP_INT(a,b,c,d);
+            r8 = b/b; KEEP_INT(a,b,c,d);
+            r9 = c/c; KEEP_INT(a,b,c,d);
+            r10 = r10/a; KEEP_INT(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -1311,7 +1713,7 @@ int long_basic_op(char *opType, unsigned long reps){
 
 int double_basic_op(char *opType, unsigned long reps){
   
-  int i;
+  unsigned long i;
   
 #ifdef ONEVOL
   double a, b, c;
@@ -1335,13 +1737,13 @@ int double_basic_op(char *opType, unsigned long reps){
   c = rand();
   d = rand();
   
-  struct timespec start, end;
+  sampler_t smp;
   
-  /* warm-up loop with nop */
-  warmup_loop(reps);
+  /* measure loop on its own with nop, calibrating reps if not given */
+  reps = loop_timer_nop(reps);
   
-  /* measure loop on its own with nop */
-  loop_timer_nop(reps);
+  /* warm-up loop with nop, over the calibrated count */
+  warmup_loop(reps);
   
   /* measure loop on its own */
   loop_timer(reps);
@@ -1354,90 +1756,123 @@ int double_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) c = a+b;
       
       /* main loops */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Addition - 1 op HR");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) c = a+d;
-      clock_gettime(CLOCK, &end);
-      elapsed_time_hr(start, end, "Double Addition - 1 op HR");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Addition - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_FP(a,b,c,d);
+            b = d+c; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Addition - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Addition - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_FP(a,b,c,d);
+            b = d+c; KEEP_FP(a,b,c,d);
+            a = b+d; KEEP_FP(a,b,c,d);
+            c = d+a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Addition - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Addition - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
-        b = c+d;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_FP(a,b,c,d);
+            b = d+c; KEEP_FP(a,b,c,d);
+            a = b+d; KEEP_FP(a,b,c,d);
+            c = d+a; KEEP_FP(a,b,c,d);
+            b = c+d; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Addition - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
-        b = c+d;
-        c = d+b;
-        a = d+c;
-        b = a+d;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Addition - 8 ops");
+      sampler_init(&smp, "Double Addition - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_FP(a,b,c,d);
+            b = d+c; KEEP_FP(a,b,c,d);
+            a = b+d; KEEP_FP(a,b,c,d);
+            c = d+a; KEEP_FP(a,b,c,d);
+            b = c+d; KEEP_FP(a,b,c,d);
+            c = d+b; KEEP_FP(a,b,c,d);
+            a = d+c; KEEP_FP(a,b,c,d);
+            b = a+d; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a+d;
-        b = d+c;
-        a = b+d;
-        c = d+a;
-        b = c+d;
-        c = d+b;
-        a = d+c;
-        b = a+d;
-        c = b+d;
-        b = c+d;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Addition - 10 ops");
+      sampler_init(&smp, "Double Addition - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a+d; KEEP_FP(a,b,c,d);
+            b = d+c; KEEP_FP(a,b,c,d);
+            a = b+d; KEEP_FP(a,b,c,d);
+            c = d+a; KEEP_FP(a,b,c,d);
+            b = c+d; KEEP_FP(a,b,c,d);
+            c = d+b; KEEP_FP(a,b,c,d);
+            a = d+c; KEEP_FP(a,b,c,d);
+            b = a+d; KEEP_FP(a,b,c,d);
+            c = b+d; KEEP_FP(a,b,c,d);
+            b = c+d; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -1447,91 +1882,123 @@ int double_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) c = a-b;
       
       /* main loop */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Subtraction - 1 op");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) c = a-b;
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Subtraction - 1 op");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Subtraction - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_FP(a,b,c,d);
+            a = b-c; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Subtraction - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Subtraction - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_FP(a,b,c,d);
+            a = b-c; KEEP_FP(a,b,c,d);
+            b = a-c; KEEP_FP(a,b,c,d);
+            c = c-a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Subtraction - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Subtraction - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
-        b = b-a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_FP(a,b,c,d);
+            a = b-c; KEEP_FP(a,b,c,d);
+            b = a-c; KEEP_FP(a,b,c,d);
+            c = c-a; KEEP_FP(a,b,c,d);
+            b = b-a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Subtraction - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
-        b = b-a;
-        c = c-b;
-        a = a-c;
-        b = b-c;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Integer Subtraction - 8 ops");
+      sampler_init(&smp, "Integer Subtraction - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_FP(a,b,c,d);
+            a = b-c; KEEP_FP(a,b,c,d);
+            b = a-c; KEEP_FP(a,b,c,d);
+            c = c-a; KEEP_FP(a,b,c,d);
+            b = b-a; KEEP_FP(a,b,c,d);
+            c = c-b; KEEP_FP(a,b,c,d);
+            a = a-c; KEEP_FP(a,b,c,d);
+            b = b-c; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a-b;
-        a = b-c;
-        b = a-c;
-        c = c-a;
-        b = b-a;
-        c = c-b;
-        a = a-c;
-        b = b-c;
-        c = b-a;
-        b = c-a;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Subtraction - 10 ops");
+      sampler_init(&smp, "Double Subtraction - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a-b; KEEP_FP(a,b,c,d);
+            a = b-c; KEEP_FP(a,b,c,d);
+            b = a-c; KEEP_FP(a,b,c,d);
+            c = c-a; KEEP_FP(a,b,c,d);
+            b = b-a; KEEP_FP(a,b,c,d);
+            c = c-b; KEEP_FP(a,b,c,d);
+            a = a-c; KEEP_FP(a,b,c,d);
+            b = b-c; KEEP_FP(a,b,c,d);
+            c = b-a; KEEP_FP(a,b,c,d);
+            b = c-a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -1541,91 +2008,123 @@ int double_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) c = a*b;
       
       /* main loop */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Multiplication - 1 op");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) c = a*b;
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Multiplication - 1 op");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Multiplication - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_FP(a,b,c,d);
+            a = b*c; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Multiplication - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Multiplication - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_FP(a,b,c,d);
+            a = b*c; KEEP_FP(a,b,c,d);
+            b = a*c; KEEP_FP(a,b,c,d);
+            c = c*a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Multiplication - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Multiplication - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
-        b = b*a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_FP(a,b,c,d);
+            a = b*c; KEEP_FP(a,b,c,d);
+            b = a*c; KEEP_FP(a,b,c,d);
+            c = c*a; KEEP_FP(a,b,c,d);
+            b = b*a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Multiplication - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
-        b = b*a;
-        c = c*b;
-        a = a*c;
-        b = b*c;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Multiplication - 8 ops");
+      sampler_init(&smp, "Double Multiplication - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_FP(a,b,c,d);
+            a = b*c; KEEP_FP(a,b,c,d);
+            b = a*c; KEEP_FP(a,b,c,d);
+            c = c*a; KEEP_FP(a,b,c,d);
+            b = b*a; KEEP_FP(a,b,c,d);
+            c = c*b; KEEP_FP(a,b,c,d);
+            a = a*c; KEEP_FP(a,b,c,d);
+            b = b*c; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        c = a*b;
-        a = b*c;
-        b = a*c;
-        c = c*a;
-        b = b*a;
-        c = c*b;
-        a = a*c;
-        b = b*c;
-        c = b*a;
-        b = c*a;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Multiplication - 10 ops");
+      sampler_init(&smp, "Double Multiplication - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            c = a*b; KEEP_FP(a,b,c,d);
+            a = b*c; KEEP_FP(a,b,c,d);
+            b = a*c; KEEP_FP(a,b,c,d);
+            c = c*a; KEEP_FP(a,b,c,d);
+            b = b*a; KEEP_FP(a,b,c,d);
+            c = c*b; KEEP_FP(a,b,c,d);
+            a = a*c; KEEP_FP(a,b,c,d);
+            b = b*c; KEEP_FP(a,b,c,d);
+            c = b*a; KEEP_FP(a,b,c,d);
+            b = c*a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
@@ -1640,91 +2139,123 @@ int double_basic_op(char *opType, unsigned long reps){
       for(i=0; i<100; i++) r1 = a/b;
       
       /* main loop */
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Division - 1 op");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++) r1 = a/b;
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Division - 1 op");
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 1 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Division - 2 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_FP(a,b,c,d);
+            r2 = b/c; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Division - 2 ops");
+      sampler_set_work(&smp, (double)reps * 2 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps / 2;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Division - 4 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_FP(a,b,c,d);
+            r2 = b/c; KEEP_FP(a,b,c,d);
+            r3 = a/c; KEEP_FP(a,b,c,d);
+            r4 = b/a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Division - 4 ops");
+      sampler_set_work(&smp, (double)reps * 4 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
+      sampler_init(&smp, "Double Division - 5 ops");
+      while(sampler_next(&smp)){
 # pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
-        r5 = c/a;
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_FP(a,b,c,d);
+            r2 = b/c; KEEP_FP(a,b,c,d);
+            r3 = a/c; KEEP_FP(a,b,c,d);
+            r4 = b/a; KEEP_FP(a,b,c,d);
+            r5 = c/a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
       }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Division - 5 ops");
+      sampler_set_work(&smp, (double)reps * 5 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 5 / 8;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
-        r5 = c/a;
-        r6 = c/b;
-        r7 = a/a;
-        r8 = b/b;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Division - 8 ops");
+      sampler_init(&smp, "Double Division - 8 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_FP(a,b,c,d);
+            r2 = b/c; KEEP_FP(a,b,c,d);
+            r3 = a/c; KEEP_FP(a,b,c,d);
+            r4 = b/a; KEEP_FP(a,b,c,d);
+            r5 = c/a; KEEP_FP(a,b,c,d);
+            r6 = c/b; KEEP_FP(a,b,c,d);
+            r7 = a/a; KEEP_FP(a,b,c,d);
+            r8 = b/b; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 8 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       reps = reps * 4 / 5;
       
-      clock_gettime(CLOCK, &start);
-# pragma omp parallel private(i) firstprivate(a,b,c,d)
-      for(i=0; i<reps; i++){
-        r1 = a/b;
-        r2 = b/c;
-        r3 = a/c;
-        r4 = b/a;
-        r5 = c/a;
-        r6 = c/b;
-        r7 = a/a;
-        r8 = b/b;
-        r9 = c/c;
-        r10 = r10/a;
-      }
-      clock_gettime(CLOCK, &end);
-      
-      elapsed_time_hr(start, end, "Double Division - 10 ops");
+      sampler_init(&smp, "Double Division - 10 ops");
+      while(sampler_next(&smp)){
+# pragma omp parallel private(i) firstprivate(a,b,c,d)
+        {
+          sampler_thread_start(&smp);
+          for(i=0; i<reps; i++){
+            r1 = a/b; KEEP_FP(a,b,c,d);
+            r2 = b/c; KEEP_FP(a,b,c,d);
+            r3 = a/c; KEEP_FP(a,b,c,d);
+            r4 = b/a; KEEP_FP(a,b,c,d);
+            r5 = c/a; KEEP_FP(a,b,c,d);
+            r6 = c/b; KEEP_FP(a,b,c,d);
+            r7 = a/a; KEEP_FP(a,b,c,d);
+            r8 = b/b; KEEP_FP(a,b,c,d);
+            r9 = c/c; KEEP_FP(a,b,c,d);
+            r10 = r10/a; KEEP_FP(a,b,c,d);
+          }
+          sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * 10 * omp_get_max_threads(), 0);
+      sampler_report(&smp);
       
       break;
     }
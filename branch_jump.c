@@ -27,6 +27,8 @@
 
 #include "level0.h"
 #include "utils.h"
+#include "stats.h"
+#include "rng.h"
 
 /*
  *
@@ -36,57 +38,66 @@
  */
 int switch_jump(unsigned long reps){
 
-	int i;
+	unsigned long i;
 	char op[] = "ABCD";
 	volatile char o;
 
-	struct timespec start, end;
+	sampler_t smp;
 
 	srand((unsigned int)time(NULL));
 
 	/* Measure loop with 'nop' */
-	clock_gettime(CLOCK, &start);
-	for(i=0; i<reps; i++){
-		__asm__("nop");
+	sampler_init(&smp, "Loop without switch statement or % operation");
+	if (reps == 0) sampler_calibrate(&smp, &reps);
+	while(sampler_next(&smp)){
+		for(i=0; i<reps; i++){
+			__asm__("nop");
+		}
 	}
-	clock_gettime(CLOCK, &end);
-	elapsed_time_hr(start, end, "Loop without switch statement or % operation");
+	sampler_report(&smp);
 
 	/* Measure loop with 'nop' and % */
-	clock_gettime(CLOCK, &start);
-	for(i=0; i<reps; i++){
-		o = op[i%4];
-		__asm__("nop");
+	sampler_init(&smp, "Loop without switch statement, but with % operation");
+	while(sampler_next(&smp)){
+		for(i=0; i<reps; i++){
+			o = op[i%4];
+			__asm__("nop");
+		}
 	}
-	clock_gettime(CLOCK, &end);
-	elapsed_time_hr(start, end, "Loop without switch statement, but with % operation");
+	sampler_report(&smp);
 
 	/* Measure loop with switch where each case performs 'nop' */
-	clock_gettime(CLOCK, &start);
+	sampler_init(&smp, "Loop with switch statement");
+	while(sampler_next(&smp)){
 #pragma omp parallel private(i)
-	for(i=0; i<reps; i++){
-
-		o = op[i%4];
-
-		switch(o) {
-		case 'A':
-			__asm__ ("nop");
-			break;
-		case 'B':
-			__asm__ ("nop");
-			break;
-		case 'C':
-			__asm__ ("nop");
-			break;
-		case 'D':
-			__asm__ ("nop");
-			break;
-		default:
-			break;
+		{
+			sampler_thread_start(&smp);
+			for(i=0; i<reps; i++){
+
+				o = op[i%4];
+
+				switch(o) {
+				case 'A':
+					__asm__ ("nop");
+					break;
+				case 'B':
+					__asm__ ("nop");
+					break;
+				case 'C':
+					__asm__ ("nop");
+					break;
+				case 'D':
+					__asm__ ("nop");
+					break;
+				default:
+					break;
+				}
+			}
+			sampler_thread_stop(&smp);
 		}
 	}
-	clock_gettime(CLOCK, &end);
-	elapsed_time_hr(start, end, "Loop with switch statement");
+	sampler_set_work(&smp, (double)reps * omp_get_max_threads(), 0);
+	sampler_report(&smp);
 
 	return 0;
 
@@ -102,7 +113,7 @@ int all_true(unsigned long reps){
 
   unsigned long N = reps;
 
-  struct timespec start, end;
+  sampler_t smp;
 
   /* warm-up */
   # pragma omp parallel private(i) firstprivate(pi)
@@ -119,31 +130,33 @@ int all_true(unsigned long reps){
     pi = pi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
   }
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      double lpi = 0.0;
-      int lcount = 0;
-      for(i = 0; i < N; i=i+10){
-	  lcount++;
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-      }
-      pi = lpi;
-      count = lcount;
+  sampler_init(&smp, "Loop without branches");
+  if (N == 0) sampler_calibrate(&smp, &N);
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        double lpi = 0.0;
+        int lcount = 0;
+        sampler_thread_start(&smp);
+        for(i = 0; i < N; i=i+10){
+	    lcount++;
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+        }
+        pi = lpi;
+        count = lcount;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "Loop without branches");
+  sampler_report(&smp);
   
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -153,50 +166,52 @@ int all_true(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      double lpi = 0.0;
-      int l_is_true = 0;
-      int l_is_false = 0;
-
-      for(i = 0; i < N; i=i+10){
-
-	  if((i & 0) == 0){
-	      l_is_true++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-	  else{
-	      l_is_false++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-      }
-      pi = lpi;
-      is_true = l_is_true;
-      is_false = l_is_false;
+  sampler_init(&smp, "All TRUE");
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        double lpi = 0.0;
+        int l_is_true = 0;
+        int l_is_false = 0;
+        sampler_thread_start(&smp);
+
+        for(i = 0; i < N; i=i+10){
+
+	    if((i & 0) == 0){
+		l_is_true++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+	    else{
+		l_is_false++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+        }
+        pi = lpi;
+        is_true = l_is_true;
+        is_false = l_is_false;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "All TRUE");
+  sampler_set_work(&smp, (double)(N / 10) * omp_get_max_threads(), 0);
+  sampler_report(&smp);
 
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -220,7 +235,7 @@ int all_false(unsigned long reps){
 
   unsigned long N = reps;
 
-  struct timespec start, end;
+  sampler_t smp;
 
   /* warm-up */
   # pragma omp parallel private(i,pi)
@@ -239,31 +254,33 @@ int all_false(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      double lpi = 0.0;
-      int lcount = 0;
-      for(i = 0; i < N; i=i+10){
-	  lcount++;
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-      }
-      pi = lpi;
-      count = lcount;
+  sampler_init(&smp, "Loop without branches");
+  if (N == 0) sampler_calibrate(&smp, &N);
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        double lpi = 0.0;
+        int lcount = 0;
+        sampler_thread_start(&smp);
+        for(i = 0; i < N; i=i+10){
+	    lcount++;
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+        }
+        pi = lpi;
+        count = lcount;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "Loop without branches");
+  sampler_report(&smp);
   
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -273,50 +290,52 @@ int all_false(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      int l_is_true = 0;
-      int l_is_false = 0;
-      double lpi = 0.0;
-
-      for(i = 0; i < N; i=i+10){
-
-	  if((i | 1) == 0){
-	      l_is_true++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-	  else{
-	      l_is_false++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-      }
-      pi = lpi;
-      is_true = l_is_true;
-      is_false = l_is_false;
+  sampler_init(&smp, "All FALSE");
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        int l_is_true = 0;
+        int l_is_false = 0;
+        double lpi = 0.0;
+        sampler_thread_start(&smp);
+
+        for(i = 0; i < N; i=i+10){
+
+	    if((i | 1) == 0){
+		l_is_true++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+	    else{
+		l_is_false++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+        }
+        pi = lpi;
+        is_true = l_is_true;
+        is_false = l_is_false;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "All FALSE");
+  sampler_set_work(&smp, (double)(N / 10) * omp_get_max_threads(), 0);
+  sampler_report(&smp);
 
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -340,7 +359,7 @@ int true_false(unsigned long reps){
 
   unsigned long N = reps;
 
-  struct timespec start, end;
+  sampler_t smp;
 
   /* warm-up */
   # pragma omp parallel private(i,pi)
@@ -359,31 +378,33 @@ int true_false(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      int lcount = 0;
-      double lpi = 0.0;
-      for(i = 0; i < N; i=i+10){
-	  lcount++;
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-      }
-      count = lcount;
-      pi = lpi;
+  sampler_init(&smp, "Loop without branches");
+  if (N == 0) sampler_calibrate(&smp, &N);
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        int lcount = 0;
+        double lpi = 0.0;
+        sampler_thread_start(&smp);
+        for(i = 0; i < N; i=i+10){
+	    lcount++;
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+        }
+        count = lcount;
+        pi = lpi;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "Loop without branches");
+  sampler_report(&smp);
   
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -393,49 +414,51 @@ int true_false(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      double lpi = 0.0;
-      int l_is_true = 0;
-      int l_is_false = 0;
-      for(i = 0; i < N; i=i+10){
-
-	  if((i & 1) == 0){
-	      l_is_true++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-	  else{
-	      l_is_false++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-      }
-      pi = lpi;
-      is_true = l_is_true;
-      is_false = l_is_false;
+  sampler_init(&smp, "TRUE-FALSE-TRUE-FALSE");
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        double lpi = 0.0;
+        int l_is_true = 0;
+        int l_is_false = 0;
+        sampler_thread_start(&smp);
+        for(i = 0; i < N; i=i+10){
+
+	    if((i & 1) == 0){
+		l_is_true++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+	    else{
+		l_is_false++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+        }
+        pi = lpi;
+        is_true = l_is_true;
+        is_false = l_is_false;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "TRUE-FALSE-TRUE-FALSE");
+  sampler_set_work(&smp, (double)(N / 10) * omp_get_max_threads(), 0);
+  sampler_report(&smp);
 
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -460,7 +483,7 @@ int t2_f2(unsigned long reps){
 
   unsigned long N = reps;
 
-  struct timespec start, end;
+  sampler_t smp;
 
   /* warm-up */
   # pragma omp parallel private(i,pi)
@@ -479,31 +502,33 @@ int t2_f2(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      double lpi = 0.0;
-      int lcount = 0;
-      for(i = 0; i < N; i=i+10){
-	  lcount++;
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-      }
-      pi = lpi;
-      count = lcount;
+  sampler_init(&smp, "Loop without branches");
+  if (N == 0) sampler_calibrate(&smp, &N);
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        double lpi = 0.0;
+        int lcount = 0;
+        sampler_thread_start(&smp);
+        for(i = 0; i < N; i=i+10){
+	    lcount++;
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+        }
+        pi = lpi;
+        count = lcount;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "Loop without branches");
+  sampler_report(&smp);
   
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -513,49 +538,51 @@ int t2_f2(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      double lpi = 0.0;
-      int l_is_true = 0;
-      int l_is_false = 0;
-      for(i = 0; i < N; i=i+10){
-
-	  if((i & 2) == 0){
-	      l_is_true++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-	  else{
-	      l_is_false++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-      }
-      pi = lpi;
-      is_true = l_is_true;
-      is_false = l_is_false;
+  sampler_init(&smp, "2xTRUE 2xFALSE");
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        double lpi = 0.0;
+        int l_is_true = 0;
+        int l_is_false = 0;
+        sampler_thread_start(&smp);
+        for(i = 0; i < N; i=i+10){
+
+	    if((i & 2) == 0){
+		l_is_true++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+	    else{
+		l_is_false++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+        }
+        pi = lpi;
+        is_true = l_is_true;
+        is_false = l_is_false;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "2xTRUE 2xFALSE");
+  sampler_set_work(&smp, (double)(N / 10) * omp_get_max_threads(), 0);
+  sampler_report(&smp);
 
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -580,7 +607,7 @@ int t4_f4(unsigned long reps){
 
   unsigned long N = reps;
 
-  struct timespec start, end;
+  sampler_t smp;
 
   /* warm-up */
   # pragma omp parallel private(i,pi)
@@ -599,31 +626,33 @@ int t4_f4(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      double lpi = 0.0;
-      int lcount = 0;
-      for(i = 0; i < N; i=i+10){
-	  lcount++;
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-      }
-      pi = lpi;
-      count = lcount;
+  sampler_init(&smp, "Loop without branches");
+  if (N == 0) sampler_calibrate(&smp, &N);
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        double lpi = 0.0;
+        int lcount = 0;
+        sampler_thread_start(&smp);
+        for(i = 0; i < N; i=i+10){
+	    lcount++;
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+        }
+        pi = lpi;
+        count = lcount;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "Loop without branches");
+  sampler_report(&smp);
   
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -633,49 +662,51 @@ int t4_f4(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      double lpi = 0.0;
-      int l_is_true = 0;
-      int l_is_false = 0;
-      for(i = 0; i < N; i=i+10){
-
-	  if((i & 4) == 0){
-	      l_is_true++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-	  else{
-	      l_is_false++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-      }
-      pi = lpi;
-      is_true = l_is_true;
-      is_false = l_is_false;
+  sampler_init(&smp, "4xTRUE 4xFALSE");
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        double lpi = 0.0;
+        int l_is_true = 0;
+        int l_is_false = 0;
+        sampler_thread_start(&smp);
+        for(i = 0; i < N; i=i+10){
+
+	    if((i & 4) == 0){
+		l_is_true++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+	    else{
+		l_is_false++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+        }
+        pi = lpi;
+        is_true = l_is_true;
+        is_false = l_is_false;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "4xTRUE 4xFALSE");
+  sampler_set_work(&smp, (double)(N / 10) * omp_get_max_threads(), 0);
+  sampler_report(&smp);
 
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -699,7 +730,7 @@ int t8_f8(unsigned long reps){
 
   unsigned long N = reps;
 
-  struct timespec start, end;
+  sampler_t smp;
 
   /* warm-up */
   # pragma omp parallel private(i,pi)
@@ -718,31 +749,33 @@ int t8_f8(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      double lpi = 0.0;
-      int lcount = 0;
-      for(i = 0; i < N; i=i+10){
-	  lcount++;
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-      }
-      pi = lpi;
-      count = lcount;
+  sampler_init(&smp, "Loop without branches");
+  if (N == 0) sampler_calibrate(&smp, &N);
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        double lpi = 0.0;
+        int lcount = 0;
+        sampler_thread_start(&smp);
+        for(i = 0; i < N; i=i+10){
+	    lcount++;
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+        }
+        pi = lpi;
+        count = lcount;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "Loop without branches");
+  sampler_report(&smp);
   
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -752,49 +785,51 @@ int t8_f8(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      double lpi = 0.0;
-      int l_is_true = 0;
-      int l_is_false = 0;
-      for(i = 0; i < N; i=i+10){
+  sampler_init(&smp, "8xTRUE 8xFALSE");
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        double lpi = 0.0;
+        int l_is_true = 0;
+        int l_is_false = 0;
+        sampler_thread_start(&smp);
+        for(i = 0; i < N; i=i+10){
 	  
-	  if((i & 8) == 0){
-	      l_is_true++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-	  else{
-	      l_is_false++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-      }
-      pi = lpi;
-      is_true = l_is_true;
-      is_false = l_is_false;
+	    if((i & 8) == 0){
+		l_is_true++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+	    else{
+		l_is_false++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+        }
+        pi = lpi;
+        is_true = l_is_true;
+        is_false = l_is_false;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "8xTRUE 8xFALSE");
+  sampler_set_work(&smp, (double)(N / 10) * omp_get_max_threads(), 0);
+  sampler_report(&smp);
 
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -818,7 +853,7 @@ int t_f_random(unsigned long reps){
   double pi, exactpi;
 
   unsigned long N = reps;
-  srand((int)time(NULL));
+  rng_t *rng = rng_thread();
 
   int *array = (int *)malloc(1000 * sizeof(int));
 
@@ -827,10 +862,10 @@ int t_f_random(unsigned long reps){
     return 0;
   }
   
-  struct timespec start, end;
+  sampler_t smp;
 
   for(i = 0; i < 1000; i++){
-    array[i] = (int)rand()/(int)(RAND_MAX/100.0);
+    array[i] = (int)rng_below(rng, 100);
   }
 
   /* warm-up */
@@ -850,32 +885,34 @@ int t_f_random(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i,t)
-  {
-      double lpi = 0.0;
-      int lcount = 0;
-      for(i = 0; i < N; i=i+10){
-	  t = array[i%1000];
-	  lcount++;
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	  lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-      }
-      pi = lpi;
-      count = lcount;
+  sampler_init(&smp, "Loop without branches");
+  if (N == 0) sampler_calibrate(&smp, &N);
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i,t)
+    {
+        double lpi = 0.0;
+        int lcount = 0;
+        sampler_thread_start(&smp);
+        for(i = 0; i < N; i=i+10){
+	    t = array[i%1000];
+	    lcount++;
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+	    lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+        }
+        pi = lpi;
+        count = lcount;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "Loop without branches");
+  sampler_report(&smp);
 
   pi = t + (pi * 4.0/((double) N));
   exactpi = 4.0*atan(1.0);
@@ -885,51 +922,53 @@ int t_f_random(unsigned long reps){
 
   pi = 0.0;
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i,t)
-  {
-      double lpi = 0.0;
-      int l_is_true = 0;
-      int l_is_false = 0;
-      for(i = 0; i < N; i=i+10){
+  sampler_init(&smp, "Random TRUE FALSE");
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i,t)
+    {
+        double lpi = 0.0;
+        int l_is_true = 0;
+        int l_is_false = 0;
+        sampler_thread_start(&smp);
+        for(i = 0; i < N; i=i+10){
 	  
-	  t = array[i%1000];
+	    t = array[i%1000];
 	  
-	  if((t % 2 ) == 0){
-	      l_is_true++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-	  else{
-	      l_is_false++;
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
-	      lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
-	  }
-      }
-      pi = lpi;
-      is_true = l_is_true;
-      is_false = l_is_false;
+	    if((t % 2 ) == 0){
+		l_is_true++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+	    else{
+		l_is_false++;
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+1)*(((double) i)-0.5)/((double) N+1) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+2)*(((double) i)-0.5)/((double) N+2) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+3)*(((double) i)-0.5)/((double) N+3) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+4)*(((double) i)-0.5)/((double) N+4) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+5)*(((double) i)-0.5)/((double) N+5) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+6)*(((double) i)-0.5)/((double) N+6) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+7)*(((double) i)-0.5)/((double) N+7) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+8)*(((double) i)-0.5)/((double) N+8) );
+		lpi = lpi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N+9)*(((double) i)-0.5)/((double) N+9) );
+	    }
+        }
+        pi = lpi;
+        is_true = l_is_true;
+        is_false = l_is_false;
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "Random TRUE FALSE");
+  sampler_set_work(&smp, (double)(N / 10) * omp_get_max_threads(), 0);
+  sampler_report(&smp);
 
   pi = t + (pi * 4.0/((double) N));
   exactpi = 4.0*atan(1.0);
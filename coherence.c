@@ -0,0 +1,256 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#include "level0.h"
+#include "utils.h"
+#include "stats.h"
+#include "results.h"
+#include "affinity.h"
+
+/*
+ * Cache coherence between threads. The line under test is aligned to
+ * two cache lines so the adjacent-line prefetcher of one core does not
+ * pull in the neighbour of another.
+ */
+#define COHERENCE_ALIGN 128
+
+/* the line bounced between two threads */
+typedef struct {
+  unsigned long v;
+  char pad[COHERENCE_ALIGN - sizeof(unsigned long)];
+} pingpong_line_t;
+
+static pingpong_line_t pingpong_line __attribute__((aligned(COHERENCE_ALIGN)));
+
+/* relation of two CPUs, for the summary of the matrix */
+#define PAIR_SMT    0
+#define PAIR_SOCKET 1
+#define PAIR_REMOTE 2
+static char *pair_names[3] = {"same core (SMT)", "same socket", "cross socket"};
+
+static int pair_kind(cpu_place_t *a, cpu_place_t *b){
+  if (a->socket != b->socket) return PAIR_REMOTE;
+  if (a->core == b->core) return PAIR_SMT;
+  return PAIR_SOCKET;
+}
+
+/*
+ * For every pair of threads of the team, the first thread writes an odd
+ * value to a shared line once it sees the even value before it, and the
+ * second writes the next even value once it sees the odd one, so the
+ * line moves from one cache to the other on every step. The latency of
+ * a step is the one-way core-to-core latency; placing the team with
+ * --bind gives the matrix of every pair of CPUs.
+ */
+int coherence_pingpong(unsigned long reps){
+
+  int nthreads, a, b, k, skipped = 0;
+  int count[3] = {0, 0, 0};
+  double sum[3] = {0.0, 0.0, 0.0}, lo[3], hi[3];
+  unsigned long steps = reps;
+  double *lat, rt;
+  char title[128];
+  cpu_place_t *pa, *pb;
+
+  sampler_t smp;
+
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  if (nthreads < 2) {
+    fprintf(stderr, "ERROR: the ping-pong benchmark needs at least two threads...\n");
+    return 0;
+  }
+
+  lat = (double *)malloc(nthreads * nthreads * sizeof(double));
+  if (!lat) {
+    printf("Out Of Memory: could not allocate space for the matrix.\n");
+    return 0;
+  }
+  for (a = 0; a < nthreads * nthreads; a++) lat[a] = -1;
+
+  for (a = 0; a < nthreads; a++) {
+    for (b = a + 1; b < nthreads; b++) {
+
+      pa = (a < affinity_threads()) ? affinity_thread(a) : NULL;
+      pb = (b < affinity_threads()) ? affinity_thread(b) : NULL;
+
+      /* two spinning threads on one CPU would only measure the scheduler */
+      if (pa && pb && pa->cpu == pb->cpu) {
+        skipped++;
+        continue;
+      }
+
+      if (pa && pb) sprintf(title, "Ping-pong, thread %d (cpu %d) <-> thread %d (cpu %d)", a, pa->cpu, b, pb->cpu);
+      else sprintf(title, "Ping-pong, thread %d <-> thread %d", a, b);
+
+      /* the first pair calibrates the number of round trips for all others */
+      sampler_init(&smp, title);
+      if (steps == 0) sampler_calibrate(&smp, &steps);
+      while(sampler_next(&smp)){
+        pingpong_line.v = 0;
+        # pragma omp parallel
+        {
+            unsigned long i;
+            int t = omp_get_thread_num();
+            if (t == a) {
+                for (i = 0; i < steps; i++) {
+                    while (__atomic_load_n(&pingpong_line.v, __ATOMIC_ACQUIRE) != 2 * i) ;
+                    __atomic_store_n(&pingpong_line.v, 2 * i + 1, __ATOMIC_RELEASE);
+                }
+            }
+            else if (t == b) {
+                for (i = 0; i < steps; i++) {
+                    while (__atomic_load_n(&pingpong_line.v, __ATOMIC_ACQUIRE) != 2 * i + 1) ;
+                    __atomic_store_n(&pingpong_line.v, 2 * i + 2, __ATOMIC_RELEASE);
+                }
+            }
+        }
+      }
+      sampler_set_work(&smp, 2.0 * steps, 0.0);
+      sampler_set_latency(&smp, 2.0 * steps);
+      rt = sampler_report(&smp);
+
+      lat[a * nthreads + b] = lat[b * nthreads + a] = rt / (2.0 * steps) * 1e9;
+
+      if (pa && pb && pa->socket >= 0 && pb->socket >= 0) {
+        k = pair_kind(pa, pb);
+        if (count[k] == 0 || lat[a * nthreads + b] < lo[k]) lo[k] = lat[a * nthreads + b];
+        if (count[k] == 0 || lat[a * nthreads + b] > hi[k]) hi[k] = lat[a * nthreads + b];
+        sum[k] += lat[a * nthreads + b];
+        count[k]++;
+      }
+    }
+  }
+
+  if (skipped) {
+    printf("Skipped %d pairs of threads that share a CPU, pin the threads with --bind.\n", skipped);
+  }
+
+  results_matrix("Core-to-core latency, one way", "ns", nthreads, lat);
+
+  if (count[PAIR_SMT] + count[PAIR_SOCKET] + count[PAIR_REMOTE] == 0) {
+    free(lat);
+    return 0;
+  }
+
+  printf("\nOne-way latency by placement of the pair:\n");
+  printf("  %-16s  %6s  %10s  %10s  %10s\n", "pair", "pairs", "min ns", "mean ns", "max ns");
+  for (k = 0; k < 3; k++) {
+    if (count[k] == 0) continue;
+    printf("  %-16s  %6d  %10.2f  %10.2f  %10.2f\n", pair_names[k], count[k], lo[k], sum[k] / count[k], hi[k]);
+  }
+  printf("\n");
+
+  free(lat);
+
+  return 0;
+}
+
+/* separations of the false sharing counters when --strides is not given */
+#define SHARING_MAX 64
+static size_t sharing_default[] = {4, 8, 16, 32, 64, 128, 256};
+
+/*
+ * Every thread increments its own int counter in one shared array, the
+ * counters 'separation' bytes apart. Below a cache line several threads
+ * write to the same line and it ping-pongs between their caches although
+ * no data is shared; at 64 bytes every counter has its own line and at
+ * 128 bytes the adjacent-line prefetcher no longer pairs them either.
+ */
+int coherence_false_sharing(unsigned long reps){
+
+  size_t seps[SHARING_MAX];
+  double rate[SHARING_MAX];
+  int nseps, k;
+  unsigned long steps = reps;
+  char *raw, *base;
+  char title[128];
+
+  sampler_t smp;
+
+  int nthreads;
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  if (mem_strides) {
+    nseps = parse_size_list(mem_strides, "separation", seps, SHARING_MAX);
+    if (nseps == 0) return 0;
+  }
+  else {
+    nseps = sizeof(sharing_default) / sizeof(size_t);
+    memcpy(seps, sharing_default, sizeof(sharing_default));
+  }
+  for (k = 0; k < nseps; k++) {
+    if (seps[k] % sizeof(int) || seps[k] > 4096) {
+      fprintf(stderr, "ERROR: the separation of the counters must be a multiple of %zu bytes up to 4K...\n", sizeof(int));
+      return 0;
+    }
+  }
+
+  /* room for the widest separation, aligned so that separation 64 gives one line per thread */
+  raw = (char *)malloc(nthreads * 4096 + COHERENCE_ALIGN);
+  if (!raw) {
+    printf("Out Of Memory: could not allocate space for the counters.\n");
+    return 0;
+  }
+  base = raw + (COHERENCE_ALIGN - (size_t)raw % COHERENCE_ALIGN) % COHERENCE_ALIGN;
+
+  for (k = 0; k < nseps; k++) {
+
+    sprintf(title, "False sharing, counters %zu bytes apart", seps[k]);
+    memset(base, 0, nthreads * 4096);
+
+    /* the first separation calibrates the increments for all others */
+    sampler_init(&smp, title);
+    if (steps == 0) sampler_calibrate(&smp, &steps);
+    while(sampler_next(&smp)){
+      # pragma omp parallel
+      {
+          unsigned long i;
+          volatile int *counter = (volatile int *)(base + omp_get_thread_num() * seps[k]);
+          sampler_thread_start(&smp);
+          for (i = 0; i < steps; i++) {
+              (*counter)++;
+          }
+          sampler_thread_stop(&smp);
+      }
+    }
+    sampler_set_work(&smp, (double)steps * nthreads, 0.0);
+    rate[k] = (double)steps * nthreads / sampler_report(&smp);
+  }
+
+  printf("\nIncrements by %d threads against the separation of their counters:\n", nthreads);
+  printf("  %10s  %14s  %14s  %12s\n", "separation", "total ops/s", "ops/s/thread", "vs widest");
+  for (k = 0; k < nseps; k++) {
+    printf("  %10zu  %14.6e  %14.6e  %12.3f\n", seps[k], rate[k], rate[k] / nthreads,
+           rate[nseps - 1] > 0.0 ? rate[k] / rate[nseps - 1] : 0.0);
+  }
+  printf("Keep result: %d\n\n", *(volatile int *)base);
+
+  free(raw);
+
+  return 0;
+}
@@ -27,6 +27,7 @@
 #include <omp.h>
 
 #include "utils.h"
+#include "stats.h"
 
 /* Part of the Pi approximation calculation */
 double piapprox(int index, unsigned int n){
@@ -70,10 +71,10 @@ int function_calls(unsigned int N){
     N = 1000000;
   }
 
-  double pi, exactpi;
+  double pi, exactpi, result = 0.0;
   int i;
 
-  struct timespec start, end;
+  sampler_t smp;
 
   pi = 0.0;
 
@@ -83,16 +84,23 @@ int function_calls(unsigned int N){
     pi = pi + 1.0/( 1.0 + (((double) i)-0.5)/((double) 1000) * (((double) i)-0.5)/((double) 1000) );
   }
 
-  clock_gettime(CLOCK, &start);
-
-  /* loop to calculate approximate vaule of pi directly */
-  # pragma omp parallel private(i) firstprivate(pi)
-  for (i=N; i>=1; i--){
-    pi = pi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+  sampler_init(&smp, "No Function Calls");
+  while(sampler_next(&smp)){
+    /* loop to calculate approximate vaule of pi directly */
+    # pragma omp parallel private(i) firstprivate(pi)
+    {
+      sampler_thread_start(&smp);
+      for (i=N; i>=1; i--){
+        pi = pi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+      }
+      /* keeping the sum stops the compiler from dropping the loop */
+      if (omp_get_thread_num() == 0) result = pi;
+      sampler_thread_stop(&smp);
+    }
   }
+  sampler_report(&smp);
 
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "No Function Calls");
+  pi = result;
 
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -113,16 +121,23 @@ int function_calls(unsigned int N){
 
   //printf("\n*** Computing approximation to pi with function calls.\n");
 
-  clock_gettime(CLOCK, &start);
-
-  /* loop to calculate approximate vaule of pi using a function */
-  # pragma omp parallel private(i) firstprivate(pi)
-  for (i=N; i>=1; i--){
-    pi = pi + piapprox(i, N);
+  sampler_init(&smp, "Function Calls");
+  while(sampler_next(&smp)){
+    /* loop to calculate approximate vaule of pi using a function */
+    # pragma omp parallel private(i) firstprivate(pi)
+    {
+      sampler_thread_start(&smp);
+      for (i=N; i>=1; i--){
+        pi = pi + piapprox(i, N);
+      }
+      if (omp_get_thread_num() == 0) result = pi;
+      sampler_thread_stop(&smp);
+    }
   }
+  sampler_set_work(&smp, (double)N * omp_get_max_threads(), 0);
+  sampler_report(&smp);
 
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "Function Calls");
+  pi = result;
 
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -136,10 +151,10 @@ int function_calls(unsigned int N){
 
 int function_calls_recursive(unsigned int N){
 
-  double pi, exactpi;
+  double pi, exactpi, result = 0.0;
   int i = 0, j = 0, rep = N;
 
-  struct timespec start, end;
+  sampler_t smp;
 
   if(N > 10000) {
     rep = N/10000;
@@ -156,19 +171,28 @@ int function_calls_recursive(unsigned int N){
 
   //printf("\n*** Computing approximation to pi without function calls.\n");
 
-  clock_gettime(CLOCK, &start);
-  
-  # pragma omp parallel private(i,j,pi)
-  for(j=0;j<rep;j++){
-    pi = 0.0;
-    /* loop to calculate approximate vaule of pi directly */
-    for (i=N; i>=1; i--){
-      pi = pi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+  sampler_init(&smp, "No Function Calls");
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i,j,pi)
+    {
+      /* summing every repetition stops the compiler from dropping them */
+      double keep = 0.0;
+      sampler_thread_start(&smp);
+      for(j=0;j<rep;j++){
+        pi = 0.0;
+        /* loop to calculate approximate vaule of pi directly */
+        for (i=N; i>=1; i--){
+          pi = pi + 1.0/( 1.0 + (((double) i)-0.5)/((double) N)*(((double) i)-0.5)/((double) N) );
+        }
+        keep += pi;
+      }
+      if (omp_get_thread_num() == 0) result = keep / rep;
+      sampler_thread_stop(&smp);
     }
   }
+  sampler_report(&smp);
 
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "No Function Calls");
+  pi = result;
 
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -189,18 +213,28 @@ int function_calls_recursive(unsigned int N){
 
   //  printf("\n*** Computing approximation to pi with function calls.\n");
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i,j,pi)
-  for(j=0;j<rep;j++){
-    pi = 0.0;
-    /* loop to calculate approximate vaule of pi using a function */
-    for (i=N; i>=1; i--){
-      pi = pi + piapprox(i, N);
+  sampler_init(&smp, "Function Calls");
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i,j,pi)
+    {
+      double keep = 0.0;
+      sampler_thread_start(&smp);
+      for(j=0;j<rep;j++){
+        pi = 0.0;
+        /* loop to calculate approximate vaule of pi using a function */
+        for (i=N; i>=1; i--){
+          pi = pi + piapprox(i, N);
+        }
+        keep += pi;
+      }
+      if (omp_get_thread_num() == 0) result = keep / rep;
+      sampler_thread_stop(&smp);
     }
   }
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "Function Calls");
+  sampler_set_work(&smp, (double)N * rep * omp_get_max_threads(), 0);
+  sampler_report(&smp);
+
+  pi = result;
 
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -218,19 +252,28 @@ int function_calls_recursive(unsigned int N){
 
   //  printf("\n*** Computing approximation to pi with recursive function.\n");
 
-  clock_gettime(CLOCK, &start);
-
-  /* loop to calculate approximate vaule of pi using a function */
+  sampler_init(&smp, "Recursive Function Calls");
+  while(sampler_next(&smp)){
+    /* loop to calculate approximate vaule of pi using a function */
 
-  i = N;
-  # pragma omp parallel private(j,pi)
-  for(j=0;j<rep;j++){
-    pi = 0.0;
-    pi = recur_piapprox(i, N);
+    i = N;
+    # pragma omp parallel private(j,pi)
+    {
+      double keep = 0.0;
+      sampler_thread_start(&smp);
+      for(j=0;j<rep;j++){
+        pi = 0.0;
+        pi = recur_piapprox(i, N);
+        keep += pi;
+      }
+      if (omp_get_thread_num() == 0) result = keep / rep;
+      sampler_thread_stop(&smp);
+    }
   }
+  sampler_set_work(&smp, (double)N * rep * omp_get_max_threads(), 0);
+  sampler_report(&smp);
 
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "Recursive Function Calls");
+  pi = result;
 
   pi = pi * 4.0/((double) N);
   exactpi = 4.0*atan(1.0);
@@ -33,13 +33,15 @@
 #include <omp.h>
 
 #include "utils.h"
+#include "stats.h"
+#include "rng.h"
 
 int mk_rm_dir(unsigned int N){
 
     char d[32]; 
     int i = 0, nanosleepInterval = 0; 
     
-    struct timespec start, end;
+    sampler_t smp_mk, smp_rm;
     struct timespec timeToSleep, timeRemaining;
     timeToSleep.tv_sec  = 0;
     timeToSleep.tv_nsec = 250000000L;    // 0.25 seconds
@@ -48,55 +50,76 @@ int mk_rm_dir(unsigned int N){
     /* to 100k to avoid creating too many directories.    */
     if(N == 2000000) N = 100000;
     
-    /* warm-up */
-    # pragma omp parallel private(i, d)
-    for(i=0; i<100;i++){
-	sprintf(d, "warmupdir_%d_%d", omp_get_thread_num(), i);
-	mkdir(d,777);
-    }
-
-    clock_gettime(CLOCK, &start);
-
-    /* create directories */
-    # pragma omp parallel private(i, d)
-    for(i=0; i<N;i++){
-	sprintf(d, "testdir_%d_%d", omp_get_thread_num(), i);
-	mkdir(d,777);
-	if ( i % 10000 == 0 ) {
-	    nanosleep(&timeToSleep, &timeRemaining);
-	    nanosleepInterval++;
+    /* each sample creates the directories and then removes */
+    /* them again, so both operations are sampled in step   */
+    sampler_init(&smp_mk, "mkdir");
+    sampler_init(&smp_rm, "rmdir");
+
+    while(!sampler_done(&smp_mk) || !sampler_done(&smp_rm)){
+
+	/* warm-up */
+	# pragma omp parallel private(i, d)
+	for(i=0; i<100;i++){
+	    sprintf(d, "warmupdir_%d_%d", omp_get_thread_num(), i);
+	    mkdir(d,777);
+	}
+
+	sampler_start(&smp_mk);
+
+	/* create directories */
+	# pragma omp parallel private(i, d)
+	{
+	    sampler_thread_start(&smp_mk);
+	    for(i=0; i<N;i++){
+		sprintf(d, "testdir_%d_%d", omp_get_thread_num(), i);
+		mkdir(d,777);
+		if ( i % 10000 == 0 ) {
+		    nanosleep(&timeToSleep, &timeRemaining);
+		    nanosleepInterval++;
+		}
+	    }
+	    sampler_thread_stop(&smp_mk);
 	}
-    }
 
-    clock_gettime(CLOCK, &end);
-    elapsed_time_hr(start, end, "mkdir");
-    printf("Slept for :%6.3f, ms.\n", 1000*nanosleepInterval*0.25);
-    nanosleepInterval = 0;
+	sampler_stop(&smp_mk);
+	printf("Slept for :%6.3f, ms.\n", 1000*nanosleepInterval*0.25);
+	nanosleepInterval = 0;
     
-    sleep(5);
-
-    /* warm-up */
-    # pragma omp parallel private(i, d)
-    for(i=0; i<100;i++){
-	sprintf(d, "warmupdir_%d_%d", omp_get_thread_num(), i);
-	rmdir(d);
-    }
-    clock_gettime(CLOCK, &start);
-
-    /* remove previously created directories */
-    # pragma omp parallel private(i, d)
-    for(i=0; i<N;i++){
-	sprintf(d, "testdir_%d_%d", omp_get_thread_num(), i);
-	rmdir(d);
-	if ( i % 10000 == 0 ) {
-	    nanosleep(&timeToSleep, &timeRemaining);
-	    nanosleepInterval++;
+	sleep(5);
+
+	/* warm-up */
+	# pragma omp parallel private(i, d)
+	for(i=0; i<100;i++){
+	    sprintf(d, "warmupdir_%d_%d", omp_get_thread_num(), i);
+	    rmdir(d);
+	}
+
+	sampler_start(&smp_rm);
+
+	/* remove previously created directories */
+	# pragma omp parallel private(i, d)
+	{
+	    sampler_thread_start(&smp_rm);
+	    for(i=0; i<N;i++){
+		sprintf(d, "testdir_%d_%d", omp_get_thread_num(), i);
+		rmdir(d);
+		if ( i % 10000 == 0 ) {
+		    nanosleep(&timeToSleep, &timeRemaining);
+		    nanosleepInterval++;
+		}
+	    }
+	    sampler_thread_stop(&smp_rm);
 	}
-    }
     
-    clock_gettime(CLOCK, &end);
-    elapsed_time_hr(start, end, "rmdir");
-    printf("Slept for :%6.3f, ms.\n", 1000*nanosleepInterval*0.25);
+	sampler_stop(&smp_rm);
+	printf("Slept for :%6.3f, ms.\n", 1000*nanosleepInterval*0.25);
+	nanosleepInterval = 0;
+    }
+
+    sampler_set_work(&smp_mk, (double)N * omp_get_max_threads(), 0);
+    sampler_report(&smp_mk);
+    sampler_set_work(&smp_rm, (double)N * omp_get_max_threads(), 0);
+    sampler_report(&smp_rm);
     
     fflush(stdout);
     return 0;
@@ -104,15 +127,16 @@ int mk_rm_dir(unsigned int N){
 
 int file_write(unsigned int N)
 {
-    struct timespec start, end;
+    sampler_t smp;
     char name[100];
     int size = 1;
-    int i, j;
+    int i;
+    unsigned long j;
     unsigned char **data;
     int warmupsize;
     char titlebuffer[500];
     int fd;
-    int reps;
+    unsigned long reps;
 
     int nthreads;
     # pragma omp parallel
@@ -169,30 +193,33 @@ int file_write(unsigned int N)
 	sprintf(titlebuffer, "file_write: %d files of %d bytes", N, size);
 
 	/* do actual write test */
-	clock_gettime(CLOCK, &start);
-
-	reps = 128 / N;
-	if (reps == 0) reps = 1;
-
-        # pragma omp parallel private(i, j, name, fd)
-	for (j = 0; j < reps; j++) {
-	    for (i = 0; i < N; i++) {
-		sprintf(name, "testfile_%d_%d", omp_get_thread_num(), i);
+	sampler_init(&smp, titlebuffer);
+	reps = 1;
+	sampler_calibrate(&smp, &reps);
+	while(sampler_next(&smp)){
+            # pragma omp parallel private(i, j, name, fd)
+	    {
+		sampler_thread_start(&smp);
+		for (j = 0; j < reps; j++) {
+		    for (i = 0; i < N; i++) {
+			sprintf(name, "testfile_%d_%d", omp_get_thread_num(), i);
 		
-		fd = open(name, O_CREAT|O_WRONLY|O_TRUNC, 0644);
-		if (fd < 0) {
-		    fprintf(stderr, "ERROR: unable to open test file for writing in file_write\n");
-		}
-		else {
-		    write(fd, data[omp_get_thread_num()], size);
-		    fsync(fd);
-		    close(fd);
+			fd = open(name, O_CREAT|O_WRONLY|O_TRUNC, 0644);
+			if (fd < 0) {
+			    fprintf(stderr, "ERROR: unable to open test file for writing in file_write\n");
+			}
+			else {
+			    write(fd, data[omp_get_thread_num()], size);
+			    fsync(fd);
+			    close(fd);
+			}
+		    }
 		}
+		sampler_thread_stop(&smp);
 	    }
 	}
-
-	clock_gettime(CLOCK, &end);
-	elapsed_time_hr(start, end, titlebuffer);
+	sampler_set_work(&smp, (double)reps * N * nthreads, (double)reps * N * size * nthreads);
+	sampler_report(&smp);
 
 	/* remove files just created */
         # pragma omp parallel private(i, name)
@@ -223,16 +250,17 @@ int file_write(unsigned int N)
 
 int file_write_random(unsigned int N)
 {
-    struct timespec start, end;
+    sampler_t smp;
     char name[100];
     int size = 1;
-    int i, j;
+    int i;
+    unsigned long j;
     unsigned char **data;
     int warmupsize;
     char titlebuffer[500];
     int fd;
     int block;
-    int reps;
+    unsigned long reps;
 
     int nthreads;
     # pragma omp parallel
@@ -279,35 +307,39 @@ int file_write_random(unsigned int N)
 
 	sprintf(titlebuffer, "file_write_random: %d blocks of %d bytes", N, size);
 
-	clock_gettime(CLOCK, &start);
-
-	reps = 128 / N;
-	if (reps == 0) reps = 1;
-
-        # pragma omp parallel private(i, j, fd, name, block)
-	for (j = 0; j < reps; j++) {
-	    for (i = 0; i < N; i++) {
-		/* open the big test file for writing */
-		sprintf(name, "testfile_%d_1", omp_get_thread_num());
-		fd = open(name, O_WRONLY);
-		if (fd < 0) {
-		    fprintf(stderr, "ERROR: unable to open test file for writing in file_write_random\n");
-		}
-		else {
-		    /* choose a random block within the file */
-		    block = rand() % N;
+	sampler_init(&smp, titlebuffer);
+	reps = 1;
+	sampler_calibrate(&smp, &reps);
+	while(sampler_next(&smp)){
+            # pragma omp parallel private(i, j, fd, name, block)
+	    {
+		rng_t *rng = rng_thread();
+		sampler_thread_start(&smp);
+		for (j = 0; j < reps; j++) {
+		    for (i = 0; i < N; i++) {
+			/* open the big test file for writing */
+			sprintf(name, "testfile_%d_1", omp_get_thread_num());
+			fd = open(name, O_WRONLY);
+			if (fd < 0) {
+			    fprintf(stderr, "ERROR: unable to open test file for writing in file_write_random\n");
+			}
+			else {
+			    /* choose a random block within the file */
+			    block = rng_below(rng, N);
 		
-		    /* write to that block */
-		    lseek(fd, block * size, SEEK_SET);
-		    write(fd, data[omp_get_thread_num()], size);
-		    fsync(fd);
-		    close(fd);
+			    /* write to that block */
+			    lseek(fd, block * size, SEEK_SET);
+			    write(fd, data[omp_get_thread_num()], size);
+			    fsync(fd);
+			    close(fd);
+			}
+		    }
 		}
+		sampler_thread_stop(&smp);
 	    }
 	}
-
-	clock_gettime(CLOCK, &end);
-	elapsed_time_hr(start, end, titlebuffer);
+	sampler_set_work(&smp, (double)reps * N * nthreads, (double)reps * N * size * nthreads);
+	sampler_report(&smp);
 
 	/* halve number of blocks but double their size */
 	N = N / 2;
@@ -328,15 +360,16 @@ int file_write_random(unsigned int N)
 
 int file_read(unsigned int N)
 {
-    struct timespec start, end;
+    sampler_t smp;
     char name[100];
     int size = 1;
-    int i, j;
+    int i;
+    unsigned long j;
     unsigned char **data;
     int warmupsize;
     char titlebuffer[500];
     int fd;
-    int reps;
+    unsigned long reps;
     
     int nthreads;
     # pragma omp parallel
@@ -383,30 +416,33 @@ int file_read(unsigned int N)
             }
 	}
 
-	reps = 32768 / N;
-	if (reps == 0) reps = 1;
-
 	/* now do read test */
-	clock_gettime(CLOCK, &start);
-
-        # pragma omp parallel private(i, j, fd, name)
-	for (j = 0; j < reps; j++) {
-	    for (i = 0; i < N; i++) {
-	        sprintf(name, "testfile_%d_%d", omp_get_thread_num(), i);
+	sampler_init(&smp, titlebuffer);
+	reps = 1;
+	sampler_calibrate(&smp, &reps);
+	while(sampler_next(&smp)){
+            # pragma omp parallel private(i, j, fd, name)
+	    {
+		sampler_thread_start(&smp);
+		for (j = 0; j < reps; j++) {
+		    for (i = 0; i < N; i++) {
+			sprintf(name, "testfile_%d_%d", omp_get_thread_num(), i);
 		
-		fd = open(name, O_RDONLY);
-		if (fd < 0) {
-		    fprintf(stderr, "ERROR: unable to open test file for reading in file_read\n");
+			fd = open(name, O_RDONLY);
+			if (fd < 0) {
+			    fprintf(stderr, "ERROR: unable to open test file for reading in file_read\n");
+			}
+			else {
+			    read(fd, data[omp_get_thread_num()], size);
+			    close(fd);
+			}
+		    }
 		}
-		else {
-	            read(fd, data[omp_get_thread_num()], size);
-	            close(fd);
-                }
+		sampler_thread_stop(&smp);
 	    }
 	}
-
-	clock_gettime(CLOCK, &end);
-	elapsed_time_hr(start, end, titlebuffer);
+	sampler_set_work(&smp, (double)reps * N * nthreads, (double)reps * N * size * nthreads);
+	sampler_report(&smp);
 
 	/* remove files just created */
         # pragma omp parallel private(i, name)
@@ -432,15 +468,16 @@ int file_read(unsigned int N)
 #ifndef __MACH__
 int file_read_direct(unsigned int N)
 {
-    struct timespec start, end;
+    sampler_t smp;
     char name[100];
     int size = 1;
-    int i, j;
+    int i;
+    unsigned long j;
     unsigned char **data_orig, **data;
     int warmupsize;
     char titlebuffer[500];
     int fd;
-    int reps;
+    unsigned long reps;
 
     int nthreads;
     # pragma omp parallel
@@ -491,30 +528,33 @@ int file_read_direct(unsigned int N)
             }
 	}
 
-	reps = 2048 / N;
-	if (reps == 0) reps = 1;
-
 	/* now do read test */
-	clock_gettime(CLOCK, &start);
-
-        # pragma omp parallel private(i, j, name, fd)
-	for (j = 0; j < reps; j++) {
-	    for (i = 0; i < N; i++) {
-                sprintf(name, "testfile_%d_%d", omp_get_thread_num(), i);
+	sampler_init(&smp, titlebuffer);
+	reps = 1;
+	sampler_calibrate(&smp, &reps);
+	while(sampler_next(&smp)){
+            # pragma omp parallel private(i, j, name, fd)
+	    {
+		sampler_thread_start(&smp);
+		for (j = 0; j < reps; j++) {
+		    for (i = 0; i < N; i++) {
+			sprintf(name, "testfile_%d_%d", omp_get_thread_num(), i);
 		
-		fd = open(name, O_RDONLY|O_DIRECT);
-		if (fd < 0) {
-		    fprintf(stderr, "ERROR: unable to open test file for reading in file_read_direct\n");
+			fd = open(name, O_RDONLY|O_DIRECT);
+			if (fd < 0) {
+			    fprintf(stderr, "ERROR: unable to open test file for reading in file_read_direct\n");
+			}
+			else {
+			    read(fd, data[omp_get_thread_num()], size);
+			    close(fd);
+			}
+		    }
 		}
-		else {
-                    read(fd, data[omp_get_thread_num()], size);
-		    close(fd);
-                }
+		sampler_thread_stop(&smp);
 	    }
 	}
-
-	clock_gettime(CLOCK, &end);
-	elapsed_time_hr(start, end, titlebuffer);
+	sampler_set_work(&smp, (double)reps * N * nthreads, (double)reps * N * size * nthreads);
+	sampler_report(&smp);
 
 	/* remove files just created */
         # pragma omp parallel private(i, name)
@@ -540,16 +580,17 @@ int file_read_direct(unsigned int N)
 
 int file_read_random(unsigned int N)
 {
-    struct timespec start, end;
+    sampler_t smp;
     char name[100];
     int size = 1;
-    int i, j;
+    int i;
+    unsigned long j;
     unsigned char **data;
     int warmupsize;
     char titlebuffer[500];
     int fd;
     int block;
-    int reps;
+    unsigned long reps;
 
     int nthreads;
     # pragma omp parallel
@@ -596,34 +637,38 @@ int file_read_random(unsigned int N)
 
 	sprintf(titlebuffer, "file_read_random: %d blocks of %d bytes", N, size);
 
-	reps = 65536 / N;
-	if (reps == 0) reps = 1;
-
-	clock_gettime(CLOCK, &start);
-
-        # pragma omp parallel private(j, i, fd, name, block)
-	for (j = 0; j < reps; j++) {
-	    for (i = 0; i < N; i++) {
-		/* open the big test file for reading */
-                sprintf(name, "testfile_%d_1", omp_get_thread_num());
-		fd = open(name, O_RDONLY);
-		if (fd < 0) {
-		    fprintf(stderr, "ERROR: unable to open test file for reading in file_read_random\n");
-		}
-		else {
-                    /* choose a random block within the file */
-                    block = rand() % N;
+	sampler_init(&smp, titlebuffer);
+	reps = 1;
+	sampler_calibrate(&smp, &reps);
+	while(sampler_next(&smp)){
+            # pragma omp parallel private(j, i, fd, name, block)
+	    {
+		rng_t *rng = rng_thread();
+		sampler_thread_start(&smp);
+		for (j = 0; j < reps; j++) {
+		    for (i = 0; i < N; i++) {
+			/* open the big test file for reading */
+			sprintf(name, "testfile_%d_1", omp_get_thread_num());
+			fd = open(name, O_RDONLY);
+			if (fd < 0) {
+			    fprintf(stderr, "ERROR: unable to open test file for reading in file_read_random\n");
+			}
+			else {
+			    /* choose a random block within the file */
+			    block = rng_below(rng, N);
 		
-		    /* write to that block */
-		    lseek(fd, block * size, SEEK_SET);
-		    read(fd, data[omp_get_thread_num()], size);
-		    close(fd);
-                }
+			    /* write to that block */
+			    lseek(fd, block * size, SEEK_SET);
+			    read(fd, data[omp_get_thread_num()], size);
+			    close(fd);
+			}
+		    }
+		}
+		sampler_thread_stop(&smp);
 	    }
 	}
-
-	clock_gettime(CLOCK, &end);
-	elapsed_time_hr(start, end, titlebuffer);
+	sampler_set_work(&smp, (double)reps * N * nthreads, (double)reps * N * size * nthreads);
+	sampler_report(&smp);
 
 	/* halve number of blocks but double their size */
 	N = N / 2;
@@ -645,16 +690,17 @@ int file_read_random(unsigned int N)
 #ifndef __MACH__
 int file_read_random_direct(unsigned int N)
 {
-    struct timespec start, end;
+    sampler_t smp;
     char name[100];
     int size = 1;
-    int i, j;
+    int i;
+    unsigned long j;
     unsigned char **data, **data_orig;
     int warmupsize;
     char titlebuffer[500];
     int fd;
     int block;
-    int reps;
+    unsigned long reps;
 
     int nthreads;
     # pragma omp parallel
@@ -704,34 +750,38 @@ int file_read_random_direct(unsigned int N)
 
 	sprintf(titlebuffer, "file_read_random_direct: %d blocks of %d bytes", N, size);
 
-	reps = 512 / N;
-	if (reps == 0) reps = 1;
-
-	clock_gettime(CLOCK, &start);
-
-        # pragma omp parallel private(i, j, fd, name, block)
-	for (j = 0; j < reps; j++) {
-	    for (i = 0; i < N; i++) {
-		/* open the big test file for reading */
-		sprintf(name, "testfile_%d_1", omp_get_thread_num());
-		fd = open(name, O_RDONLY|O_DIRECT);
-		if (fd < 0) {
-		    fprintf(stderr, "ERROR: unable to open test file for reading in file_read_random_direct\n");
-		}
-		else {
-		    /* choose a random block within the file */
-		    block = rand() % N;
+	sampler_init(&smp, titlebuffer);
+	reps = 1;
+	sampler_calibrate(&smp, &reps);
+	while(sampler_next(&smp)){
+            # pragma omp parallel private(i, j, fd, name, block)
+	    {
+		rng_t *rng = rng_thread();
+		sampler_thread_start(&smp);
+		for (j = 0; j < reps; j++) {
+		    for (i = 0; i < N; i++) {
+			/* open the big test file for reading */
+			sprintf(name, "testfile_%d_1", omp_get_thread_num());
+			fd = open(name, O_RDONLY|O_DIRECT);
+			if (fd < 0) {
+			    fprintf(stderr, "ERROR: unable to open test file for reading in file_read_random_direct\n");
+			}
+			else {
+			    /* choose a random block within the file */
+			    block = rng_below(rng, N);
 		
-		    /* write to that block */
-		    lseek(fd, block * size, SEEK_SET);
-		    read(fd, data[omp_get_thread_num()], size);
-		    close(fd);
+			    /* write to that block */
+			    lseek(fd, block * size, SEEK_SET);
+			    read(fd, data[omp_get_thread_num()], size);
+			    close(fd);
+			}
+		    }
 		}
+		sampler_thread_stop(&smp);
 	    }
 	}
-
-	clock_gettime(CLOCK, &end);
-	elapsed_time_hr(start, end, titlebuffer);
+	sampler_set_work(&smp, (double)reps * N * nthreads, (double)reps * N * size * nthreads);
+	sampler_report(&smp);
 
 	/* halve number of blocks but double their size */
 	N = N / 2;
@@ -22,16 +22,143 @@
 #include <stdio.h>
 #include <string.h>
 #include <limits.h>
+#include <omp.h>
 
 #include "level0.h"
+#include "results.h"
+#include "affinity.h"
+
+/*
+ * Parse a thread-count list: comma separated counts, where "max" stands
+ * for the number of processors, or "pow2" for all powers of two up to
+ * the number of processors (plus that number itself if it is not one).
+ * Returns the number of entries, or 0 on error.
+ */
+static int parse_threads(char *list, int **counts){
+
+  int nprocs = omp_get_num_procs();
+  int n = 0, cap = 8, v;
+  int *c, *p;
+  char *copy, *tok, *end;
+
+  c = (int *)malloc(cap * sizeof(int));
+  if (!c) return 0;
+
+  if (strcmp(list, "pow2") == 0) {
+    for (v = 1; v <= nprocs; v *= 2) {
+      if (n == cap) {
+        cap *= 2;
+        p = (int *)realloc(c, cap * sizeof(int));
+        if (!p) { free(c); return 0; }
+        c = p;
+      }
+      c[n++] = v;
+    }
+    if (n > 0 && c[n-1] != nprocs) {
+      if (n == cap) {
+        p = (int *)realloc(c, (cap + 1) * sizeof(int));
+        if (!p) { free(c); return 0; }
+        c = p;
+      }
+      c[n++] = nprocs;
+    }
+    *counts = c;
+    return n;
+  }
+
+  copy = strdup(list);
+  if (!copy) { free(c); return 0; }
+
+  for (tok = strtok(copy, ","); tok; tok = strtok(NULL, ",")) {
+    if (strcmp(tok, "max") == 0) v = nprocs;
+    else {
+      v = (int)strtol(tok, &end, 10);
+      if (*end != '\0' || v < 1) {
+        fprintf(stderr, "ERROR: invalid thread count %s in --threads\n", tok);
+        free(copy);
+        free(c);
+        return 0;
+      }
+    }
+    if (n == cap) {
+      cap *= 2;
+      p = (int *)realloc(c, cap * sizeof(int));
+      if (!p) { free(copy); free(c); return 0; }
+      c = p;
+    }
+    c[n++] = v;
+  }
+
+  free(copy);
+  *counts = c;
+  return n;
+}
+
+static void run_level0(char *b, unsigned int s, size_t nbytes, unsigned int t, unsigned long r, char *o, char *dt);
 
 /*
  *
  * Level 0 benchmark driver - calls appropriate function
- * based on command line arguments.
+ * based on command line arguments. With a thread list the
+ * benchmark is rerun at every thread count and the scaling
+ * of every region is reported at the end. The size is a
+ * count, except for the memory benchmarks where it is a
+ * byte count if size_unit is set and MBytes otherwise.
  *
  */
-void bench_level0(char *b, unsigned int s, unsigned int t, unsigned long r, char *o, char *dt){
+void bench_level0(char *b, size_t size, int size_unit, unsigned int t, unsigned long r, char *o, char *dt, char *th){
+
+  int *counts;
+  int n, i;
+  unsigned int s;
+  size_t nbytes;
+
+  /* memory benchmarks take a byte count, everything else a count */
+  if (strcmp(b, "memory") == 0) {
+    if (!size_unit && size > (size_t)-1 / 1048576) {
+      fprintf(stderr, "ERROR: size is too large...\n");
+      return;
+    }
+    nbytes = size_unit ? size : size * 1048576;
+    s = 0;
+    results_set_context(b, o, dt, nbytes, t);
+  }
+  else {
+    if (size > UINT_MAX) {
+      fprintf(stderr, "ERROR: size is too large for the %s benchmark...\n", b);
+      return;
+    }
+    nbytes = 0;
+    s = (unsigned int)size;
+    results_set_context(b, o, dt, s, t);
+  }
+
+  if (th == NULL) {
+    affinity_apply();
+    run_level0(b, s, nbytes, t, r, o, dt);
+    return;
+  }
+
+  n = parse_threads(th, &counts);
+  if (n == 0) {
+    fprintf(stderr, "ERROR: check the list given to --threads...\n");
+    return;
+  }
+
+  results_sweep_begin();
+  for (i = 0; i < n; i++) {
+    omp_set_num_threads(counts[i]);
+    printf("\n=== Running with %d threads\n", counts[i]);
+    affinity_apply();
+    results_sweep_step();
+    run_level0(b, s, nbytes, t, r, o, dt);
+  }
+  results_sweep_end();
+
+  free(counts);
+}
+
+static void run_level0(char *b, unsigned int s, size_t nbytes, unsigned int t, unsigned long r, char *o, char *dt){
 
   /* basic operations */
   if(strcmp(b, "basic_op") == 0){
@@ -55,32 +182,99 @@ void bench_level0(char *b, unsigned int s, unsigned int t, unsigned long r, char
   else if(strcmp(b, "memory") == 0){
 
     if(strcmp(o, "calloc") == 0)
-      mem_calloc(s);
+      mem_calloc(nbytes);
 
     else if(strcmp(o, "read_ram") == 0)
       mem_read_ram(r);
 
     else if(strcmp(o, "write_contig") == 0)
-      mem_write_contig(s);
+      mem_write_contig(nbytes);
 
     else if(strcmp(o, "write_strided") == 0)
-      mem_write_strided(s, t);
+      mem_write_strided(nbytes, t);
 
     else if(strcmp(o, "write_random") == 0)
-      mem_write_random(s);
+      mem_write_random(nbytes);
 
     else if(strcmp(o, "read_contig") == 0)
-      mem_read_contig(s);
+      mem_read_contig(nbytes);
 
     else if(strcmp(o, "read_strided") == 0)
-      mem_read_strided(s, t);
+      mem_read_strided(nbytes, t);
 
     else if(strcmp(o, "read_random") == 0)
-      mem_read_random(s);
+      mem_read_random(nbytes);
+
+    else if(strcmp(o, "stride_read") == 0)
+      mem_stride_sweep(nbytes, t, 0);
+
+    else if(strcmp(o, "stride_write") == 0)
+      mem_stride_sweep(nbytes, t, 1);
+
+    else if(strcmp(o, "trace") == 0)
+      mem_trace(nbytes);
+
+    else if(strcmp(o, "gather") == 0)
+      mem_indirect(nbytes, 0);
+
+    else if(strcmp(o, "scatter") == 0)
+      mem_indirect(nbytes, 1);
+
+    else if(strcmp(o, "latency") == 0)
+      mem_latency(nbytes, r, 0);
+
+    else if(strcmp(o, "latency_page") == 0)
+      mem_latency(nbytes, r, 1);
+
+    else if(strcmp(o, "loaded_latency") == 0)
+      mem_loaded_latency(nbytes, r, 0);
+
+    else if(strcmp(o, "loaded_latency_write") == 0)
+      mem_loaded_latency(nbytes, r, 1);
+
+    else if(strcmp(o, "cache_sweep") == 0)
+      mem_cache_sweep(nbytes);
+
+    else if(strcmp(o, "tlb_sweep") == 0)
+      mem_tlb_sweep(nbytes, r);
+
+    else if(strcmp(o, "stream") == 0)
+      mem_stream(nbytes, "all");
+
+    else if(strncmp(o, "stream_", 7) == 0)
+      mem_stream(nbytes, o + 7);
+
+    else if(strcmp(o, "vector") == 0)
+      mem_vector(nbytes, "all");
+
+    else if(strncmp(o, "vector_", 7) == 0)
+      mem_vector(nbytes, o + 7);
 
     else fprintf(stderr, "ERROR: check you are using a valid operation type...\n");
   }
 
+  /* cache coherence between threads */
+  else if(strcmp(b, "coherence") == 0){
+
+    if(strcmp(o, "pingpong") == 0)
+      coherence_pingpong(r);
+
+    else if(strcmp(o, "false_sharing") == 0)
+      coherence_false_sharing(r);
+
+    else fprintf(stderr, "ERROR: check you are using a valid operation type...\n");
+  }
+
+  /* atomic operations */
+  else if(strcmp(b, "atomic") == 0){
+    atomic_bench(o, dt, r);
+  }
+
+  /* memory allocators */
+  else if(strcmp(b, "alloc") == 0){
+    alloc_bench(o, s, r);
+  }
+
   /* function calls*/
   else if(strcmp(b, "function") == 0){
 
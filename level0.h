@@ -18,7 +18,9 @@
 /* See the License for the specific language governing permissions and */
 /* limitations under the License. */
 
-void bench_level0(char *, unsigned int, unsigned int, unsigned long, char *, char *);
+#include <stddef.h>
+
+void bench_level0(char *, size_t, int, unsigned int, unsigned long, char *, char *, char *);
 
 /* Basic op */
 int int_basic_op(char *, unsigned long);
@@ -27,14 +29,36 @@ int double_basic_op(char *, unsigned long);
 int long_basic_op(char *, unsigned long);
 
 /* Memory */
-int mem_calloc(unsigned int);
+extern char *mem_strides;
+extern char *mem_elements;
+extern char *mem_locality;
+int mem_calloc(size_t);
 int mem_read_ram(unsigned long);
-int mem_write_contig(unsigned int);
-int mem_write_strided(unsigned int, unsigned int);
-int mem_write_random(unsigned int);
-int mem_read_contig(unsigned int);
-int mem_read_strided(unsigned int, unsigned int);
-int mem_read_random(unsigned int);
+int mem_write_contig(size_t);
+int mem_write_strided(size_t, unsigned int);
+int mem_write_random(size_t);
+int mem_read_contig(size_t);
+int mem_read_strided(size_t, unsigned int);
+int mem_read_random(size_t);
+int mem_stride_sweep(size_t, unsigned int, int);
+int mem_trace(size_t);
+int mem_indirect(size_t, int);
+int mem_latency(size_t, unsigned long, int);
+int mem_loaded_latency(size_t, unsigned long, int);
+int mem_tlb_sweep(size_t, unsigned long);
+int mem_stream(size_t, char *);
+int mem_vector(size_t, char *);
+int mem_cache_sweep(size_t);
+
+/* Cache coherence */
+int coherence_pingpong(unsigned long);
+int coherence_false_sharing(unsigned long);
+
+/* Atomics */
+int atomic_bench(char *, char *, unsigned long);
+
+/* Allocators */
+int alloc_bench(char *, unsigned int, unsigned long);
 
 /* Function calls */
 int function_calls(unsigned int);
@@ -22,9 +22,21 @@
 #include <stdlib.h>
 #include <getopt.h>
 #include <limits.h>
+#include <time.h>
 #include <sys/utsname.h>
 
 #include "level0.h"
+#include "stats.h"
+#include "results.h"
+#include "timer.h"
+#include "perfctr.h"
+#include "affinity.h"
+#include "numa.h"
+#include "rng.h"
+#include "simd.h"
+#include "pages.h"
+#include "trace.h"
+#include "utils.h"
 
 void usage();
 void info();
@@ -34,11 +46,14 @@ int main(int argc, char **argv){
   int c;
   
   char *bench = "basic_op";
-  unsigned long rep = ULONG_MAX;
-  unsigned int size = 200;
+  unsigned long rep = 0;
+  size_t size = 200;
+  int size_unit = 0;
+  char sbuf[32];
   unsigned int stride = 64;
   char *op  = "+";
   char *dt = "int";
+  char *threads = NULL;
   
   static struct option option_list[] =
     { {"bench", required_argument, NULL, 'b'},
@@ -47,20 +62,46 @@ int main(int argc, char **argv){
       {"reps", required_argument, NULL, 'r'},
       {"op", required_argument, NULL, 'o'},
       {"dtype", required_argument, NULL, 'd'},
+      {"samples", required_argument, NULL, 'n'},
+      {"max-samples", required_argument, NULL, 'm'},
+      {"ci", required_argument, NULL, 'c'},
+      {"min-time", required_argument, NULL, 'M'},
+      {"format", required_argument, NULL, 'f'},
+      {"output", required_argument, NULL, 'O'},
+      {"timer", required_argument, NULL, 'T'},
+      {"counters", no_argument, NULL, 'P'},
+      {"threads", required_argument, NULL, 'p'},
+      {"bind", required_argument, NULL, 'B'},
+      {"numa", required_argument, NULL, 'N'},
+      {"seed", required_argument, NULL, 'S'},
+      {"precompute", no_argument, NULL, 'I'},
+      {"vector-width", required_argument, NULL, 'V'},
+      {"stores", required_argument, NULL, 'w'},
+      {"cold", no_argument, NULL, 'C'},
+      {"pages", required_argument, NULL, 'H'},
+      {"strides", required_argument, NULL, 'L'},
+      {"elements", required_argument, NULL, 'E'},
+      {"trace", required_argument, NULL, 'R'},
+      {"trace-out", required_argument, NULL, 'W'},
+      {"locality", required_argument, NULL, 'G'},
       {"info", no_argument, NULL, 'i'},
       {"help", no_argument, NULL, 'h'},
       {0, 0, 0, 0}
     };
 
-  while((c = getopt_long(argc, argv, "b:s:t:r:o:d:ih", option_list, NULL)) != -1){
+  while((c = getopt_long(argc, argv, "b:s:t:r:o:d:n:m:c:M:f:O:T:Pp:B:N:S:IV:w:CH:L:E:R:W:G:ih", option_list, NULL)) != -1){
     switch(c){
     case 'b':
       bench = optarg;
       printf("Benchmark is %s.\n", bench);
       break;
     case 's':
-      size = atoi(optarg);
-      printf("Size is %d.\n", size);
+      if (parse_size(optarg, &size, &size_unit)) {
+        fprintf(stderr, "ERROR: invalid size %s\n", optarg);
+        return 1;
+      }
+      if (size_unit) printf("Size is %s.\n", format_bytes(sbuf, size));
+      else printf("Size is %zu.\n", size);
       break;
     case 't':
       stride = atoi(optarg);
@@ -78,6 +119,91 @@ int main(int argc, char **argv){
       dt = optarg;
       printf("Data type is %s\n", dt);
       break;
+    case 'n':
+      stat_min_samples = atoi(optarg);
+      printf("Minimum number of samples %u.\n", stat_min_samples);
+      break;
+    case 'm':
+      stat_max_samples = atoi(optarg);
+      printf("Maximum number of samples %u.\n", stat_max_samples);
+      break;
+    case 'c':
+      stat_target_ci = atof(optarg);
+      printf("Target relative 95%% CI half-width %f.\n", stat_target_ci);
+      break;
+    case 'M':
+      stat_min_time = atof(optarg);
+      printf("Minimum duration of a calibrated sample %f s.\n", stat_min_time);
+      break;
+    case 'f':
+      if (results_set_format(optarg)) return 1;
+      printf("Results format is %s.\n", optarg);
+      break;
+    case 'O':
+      if (results_open(optarg)) return 1;
+      printf("Results are written to %s.\n", optarg);
+      break;
+    case 'T':
+      if (timer_select(optarg)) return 1;
+      break;
+    case 'P':
+      perf_enabled = 1;
+      printf("Hardware performance counters enabled.\n");
+      break;
+    case 'p':
+      threads = optarg;
+      printf("Thread counts %s.\n", threads);
+      break;
+    case 'B':
+      if (affinity_select(optarg)) return 1;
+      printf("Thread binding %s.\n", optarg);
+      break;
+    case 'N':
+      if (numa_select(optarg)) return 1;
+      printf("NUMA placement %s.\n", optarg);
+      break;
+    case 'S':
+      if (rng_set_seed(optarg)) return 1;
+      break;
+    case 'I':
+      rng_precompute = 1;
+      printf("Random indices are precomputed.\n");
+      break;
+    case 'V':
+      if (simd_select(optarg)) return 1;
+      printf("Vector width %s.\n", optarg);
+      break;
+    case 'w':
+      if (simd_select_stores(optarg)) return 1;
+      printf("Store mode %s.\n", optarg);
+      break;
+    case 'C':
+      if (simd_enable_cold()) return 1;
+      printf("Caches are flushed before every sample.\n");
+      break;
+    case 'H':
+      if (pages_select(optarg)) return 1;
+      printf("Page size %s.\n", optarg);
+      break;
+    case 'L':
+      mem_strides = optarg;
+      printf("Strides %s.\n", mem_strides);
+      break;
+    case 'E':
+      mem_elements = optarg;
+      printf("Element sizes %s.\n", mem_elements);
+      break;
+    case 'R':
+      trace_spec = optarg;
+      printf("Trace %s.\n", trace_spec);
+      break;
+    case 'W':
+      trace_out = optarg;
+      break;
+    case 'G':
+      mem_locality = optarg;
+      printf("Index localities %s.\n", mem_locality);
+      break;
     case 'i':
       info();
       return 0;
@@ -90,7 +216,12 @@ int main(int argc, char **argv){
     }
   }
     
-  bench_level0(bench, size, stride, rep, op, dt);
+  timer_init();
+  rng_setup();
+
+  bench_level0(bench, size, size_unit, stride, rep, op, dt, threads);
+
+  results_close();
   
   return 0;
   
@@ -99,20 +230,71 @@ int main(int argc, char **argv){
 
 void usage(){
   printf("Usage for OpenMP MICRO benchmarks:\n\n");
-  printf("\t -b, --bench NAME \t name of the benchmark - possible values are basic_op, memory, function, io and branch.\n");
+  printf("\t -b, --bench NAME \t name of the benchmark - possible values are basic_op, memory, coherence, atomic, alloc, function, io and branch.\n");
   printf("\t -s, --size N \t\t number of elements/files/directories. Default is 200.\n");
   printf("\t\t\t\t  --> for the function benchmark, this value should be set to at least 100 million.\n");
-  printf("\t\t\t\t  --> for the memory benchmark, this value should be the amount of memory to allocate/use in MBytes.\n");
+  printf("\t\t\t\t  --> for the memory benchmark, this value is the amount of memory per thread, in MBytes\n");
+  printf("\t\t\t\t      unless it carries a K, M or G suffix (powers of 1024), e.g. 16K, 1.5M or 4G.\n");
+  printf("\t\t\t\t  --> for the alloc benchmark, this value is the block size in bytes of the fixed size distribution.\n");
   printf("\t -t, --stride N \t optional stride value (in KB) for memory benchmarks write_strided and read_strided. Default is 64KB.\n");
-  printf("\t -r, --reps N \t\t number of repetitions. Default value is ULONG_MAX.\n");
+  printf("\t -r, --reps N \t\t number of repetitions. Default is 0, i.e. calibrate until a sample takes --min-time.\n");
   printf("\t -o, --op TYPE \t\t TYPE of operation.\n");
   printf("\t\t\t\t --> for basic_op benchmark: \"+\", \"-\", \"*\" and \"/\". Default is \"+\".\n");
   printf("\t\t\t\t --> for memory   benchmark: \"calloc\", \"read_ram\", \"write_contig\", \"write_strided\", \"write_random\",\n");
-  printf("\t\t\t\t \"read_contig\", \"read_strided\", \"read_random\".\n");
+  printf("\t\t\t\t \"read_contig\", \"read_strided\", \"read_random\", \"latency\", \"latency_page\",\n");
+  printf("\t\t\t\t \"stream\" (all STREAM kernels) or one of \"stream_copy\", \"stream_scale\", \"stream_add\", \"stream_triad\",\n");
+  printf("\t\t\t\t \"stream_sum\", \"stream_fill\", \"cache_sweep\", \"vector\" (explicit SIMD read, write and copy) or one of\n");
+  printf("\t\t\t\t \"vector_read\", \"vector_write\", \"vector_copy\", \"tlb_sweep\", \"stride_read\", \"stride_write\",\n");
+  printf("\t\t\t\t \"trace\" (replay of --trace), \"gather\", \"scatter\", \"loaded_latency\", \"loaded_latency_write\".\n");
+  printf("\t\t\t\t --> for coherence benchmark: \"pingpong\" (core-to-core latency matrix of the threads), \"false_sharing\".\n");
+  printf("\t\t\t\t --> for atomic benchmark: \"fetch_add\", \"cas\", \"exchange\", \"omp_atomic\", \"omp_atomic_capture\" or \"all\",\n");
+  printf("\t\t\t\t on the data type given with --dtype (int, long or double).\n");
+  printf("\t\t\t\t --> for alloc benchmark: \"malloc\", \"calloc\", \"aligned_alloc\", \"cross_thread\" or \"all\".\n");
   printf("\t\t\t\t --> for IO benchmark: \"mk_rm_dir\", \"file_write\", \"file_read\", \"file_write_random\", \"file_read_random\", \"file_read_direct\", \"file_read_random_direct\".\n");
   printf("\t\t\t\t --> for function benchmark: \"normal\", \"recursive\".\n");  
   printf("\t\t\t\t --> for branch benchmark: \"switch\", \"all_true\", \"all_false\", \"true_false\", \"t2_f2\", \"t4_f4\", \"t8_f8\", \"t_f_random\".\n");
   printf("\t -d, --dtype DATATYPE \t DATATYPE to be used - possible values are int, long, float, double. Default is int.\n");
+  printf("\t -n, --samples N \t number of samples taken of every timed region. Default is 5.\n");
+  printf("\t -m, --max-samples N \t upper bound on the number of samples when --ci is set. Default is 100.\n");
+  printf("\t -c, --ci X \t\t keep sampling until the 95%% confidence interval half-width is below X times the mean\n");
+  printf("\t\t\t\t  (e.g. 0.01 for +/- 1%%). Default is 0, i.e. take exactly --samples samples.\n");
+  printf("\t -M, --min-time X \t minimum duration in seconds of one sample when the repetition count is calibrated.\n");
+  printf("\t\t\t\t  Used by basic_op, branch and read_ram when --reps is not given, and by all IO benchmarks. Default is 0.1.\n");
+  printf("\t -f, --format FORMAT \t format of the results - text (default), json (one object per line) or csv.\n");
+  printf("\t -O, --output FILE \t write the results to FILE instead of standard output.\n");
+  printf("\t -T, --timer NAME \t timer used for sampling - auto (default), tsc or clock. tsc reads the invariant time stamp\n");
+  printf("\t\t\t\t  counter (rdtscp on x86, cntvct_el0 on AArch64), clock uses clock_gettime.\n");
+  printf("\t -P, --counters \t collect cycles, instructions, branch misses and L1D/LLC/dTLB read misses for every timed\n");
+  printf("\t\t\t\t  region with perf_event_open and report IPC, MPKI and misses per operation.\n");
+  printf("\t -p, --threads LIST \t rerun the benchmark with each number of threads in LIST, e.g. 1,2,4,max, or pow2 for\n");
+  printf("\t\t\t\t  powers of two up to the number of processors, and report speedup and efficiency of every region.\n");
+  printf("\t -B, --bind MODE \t pin every thread to one CPU - compact (SMT siblings first), cores (one thread per core\n");
+  printf("\t\t\t\t  first), scatter (round-robin over sockets) or an explicit CPU list such as 0,2,4-7.\n");
+  printf("\t\t\t\t  Default is none, i.e. leave placement to OMP_PLACES/OMP_PROC_BIND and only report it.\n");
+  printf("\t -N, --numa MODE \t placement of the per-thread arrays of the memory benchmarks - off (default, allocated\n");
+  printf("\t\t\t\t  and filled by the master thread), first-touch (by the owning thread), local, remote or\n");
+  printf("\t\t\t\t  interleave (mbind relative to the owning thread's node) or a node number N.\n");
+  printf("\t -S, --seed N \t\t seed of the per-thread random number generators. Default is the current time.\n");
+  printf("\t -I, --precompute \t draw the random indices of write_random and read_random before timing, so the\n");
+  printf("\t\t\t\t  timed loops only read an index stream.\n");
+  printf("\t -V, --vector-width W \t vector width of the vector_* memory kernels - scalar, 128 (SSE2/NEON), 256 (AVX),\n");
+  printf("\t\t\t\t  512 (AVX-512) or all (default), i.e. every width this CPU supports.\n");
+  printf("\t -w, --stores MODE \t stores of write_contig and write_strided - normal (default) or nt, non-temporal stores\n");
+  printf("\t\t\t\t  that bypass the caches and avoid the read for ownership of every line written.\n");
+  printf("\t -C, --cold \t\t flush the arrays of the contiguous and strided memory benchmarks from the caches\n");
+  printf("\t\t\t\t  (clflushopt/clflush, dc civac) before every sample.\n");
+  printf("\t -H, --pages SIZE \t page size of the memory benchmark arrays - default (as the system sets it), 4K (no\n");
+  printf("\t\t\t\t  transparent huge pages), thp (madvise MADV_HUGEPAGE), 2M or 1G (hugetlbfs, MAP_HUGETLB).\n");
+  printf("\t -L, --strides LIST \t strides in bytes for stride_read and stride_write, e.g. 64,192,4K,4160. Default is\n");
+  printf("\t\t\t\t  powers of two from 64 bytes up to --stride KB and the points half way between.\n");
+  printf("\t\t\t\t  For false_sharing, the separations of the counters, by default 4 up to 256 bytes.\n");
+  printf("\t -E, --elements LIST \t element sizes in bytes for stride_read and stride_write - any of 1, 4, 8, 16 and 64.\n");
+  printf("\t\t\t\t  Default is 4.\n");
+  printf("\t -R, --trace SPEC \t trace replayed by the trace memory benchmark - a trace file or a pattern of comma\n");
+  printf("\t\t\t\t  separated phases seq, stride:S, gather[:N], scatter[:N], blocked:B and stencil[:W].\n");
+  printf("\t -W, --trace-out FILE \t also write the trace in the binary trace format to FILE.\n");
+  printf("\t -G, --locality LIST \t index localities of gather and scatter - sorted, blocked[:B] (blocks of B elements,\n");
+  printf("\t\t\t\t  default 64), random and dup[:P] (a fraction P repeats a recent index, default 0.5). Default is all.\n");
   printf("\t -i, --info \t\t Print out system information such as current CPU frequency, core counts, cache size, plus datatype sizes.\n");
   printf("\t -h, --help \t\t Displays this help.\n");
   printf("\n\n");
@@ -132,6 +314,13 @@ void info(){
   printf("Size of long: \t\t%lu bytes\n", sizeof(long));
   printf("Size of float: \t\t%lu bytes\n", sizeof(float));
   printf("Size of double: \t%lu bytes\n", sizeof(double));
+  printf("Vector widths: \t\t");
+  {
+    int widths[4], n, i;
+    n = simd_widths(widths);
+    for (i = 0; i < n; i++) printf("%s%s", i ? ", " : "", simd_name(widths[i]));
+  }
+  printf("\n");
   printf("***************************************\n");
   printf("\n\n");
 }
@@ -24,57 +24,57 @@
 #include <string.h>
 #include <signal.h>
 #include <time.h>
+#include <limits.h>
 #include <omp.h>
 
 #include "level0.h"
 #include "utils.h"
+#include "stats.h"
+#include "timer.h"
+#include "numa.h"
+#include "rng.h"
+#include "simd.h"
+#include "pages.h"
+#include "trace.h"
 
 
-/* callocate 'size' amount of memory (in MB), then free it. */
-int mem_calloc(unsigned int size){
+/* callocate 'nbytes' bytes of memory per thread, then free it. */
+int mem_calloc(size_t nbytes){
     
-  struct timespec start, end;
+  sampler_t smp;
 
-  int i;
+  int failed = 0;
+  char buf[32];
 
-  /* work out requested size in Bytes */
-  int nbytes = size * 1048576;
-  int nelements = nbytes / sizeof(int);
+  size_t nelements = nbytes / sizeof(int);
 
   int nthreads;
   # pragma omp parallel
   if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
 
-  int **arrays = (int **)malloc(nthreads * sizeof(int*));
-  if (!arrays) {
-      printf("Out of memory.\n");
-      return 0;
+  sampler_init(&smp, "Allocate memory");
+  while(sampler_next(&smp)){
+    # pragma omp parallel reduction(+:failed)
+    {
+        /* allocate array of nbytes, free it outside the timed part */
+        int *array;
+        sampler_thread_start(&smp);
+        array = (int *)calloc(nelements, sizeof(int));
+        sampler_thread_stop(&smp);
+        if (array == NULL) failed++;
+        free(array);
+    }
   }
+  sampler_set_work(&smp, 0, (double)nbytes * nthreads);
+  sampler_report(&smp);
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel
-  {
-      /* allocate array of nbytes */
-      int threadid = omp_get_thread_num();
-      arrays[threadid] = (int *)calloc(nelements, sizeof(int));
+  if (failed) {
+      printf("Out Of Memory: %d allocations of %s failed.\n", failed, format_bytes(buf, nbytes));
+      return 0;
   }
-  clock_gettime(CLOCK, &end);
-  
-  elapsed_time_hr(start, end, "Allocate memory");
-  
-  printf("Finished callocating %d MB memory.\n\n", size);
 
-  for (i = 0; i < nthreads; i++) {
-      if(arrays[i] == NULL){
-	  printf("Out Of Memory: could not allocate space for the array.\n");
-	  return 0;
-      }
-      free(arrays[i]);
-  }
- 
-  free(arrays); // Remember to free !
-    
+  printf("Finished callocating %s memory.\n\n", format_bytes(buf, nbytes));
+
   return 0;
   
 }
@@ -82,641 +82,2055 @@ int mem_calloc(unsigned int size){
 /* measure main memory (RAM) reads */
 int mem_read_ram(unsigned long reps){
 
-  struct timespec start, end;
+  sampler_t smp;
 
-  int i, a;
+  unsigned long i;
+  int a;
   volatile int b, c;
 
-  srand((int)time(NULL));
-  b = rand();
-  c = rand();
-
-  clock_gettime(CLOCK, &start);
+  b = (int)rng_next(rng_thread());
+  c = (int)rng_next(rng_thread());
 
-
-  for(i=0; i<reps; i++){
-    a = b + c;
+  sampler_init(&smp, "RAM reads");
+  if (reps == 0) sampler_calibrate(&smp, &reps);
+  while(sampler_next(&smp)){
+    for(i=0; i<reps; i++){
+      a = b + c;
+    }
   }
-
-  clock_gettime(CLOCK, &end);
-  elapsed_time_hr(start, end, "RAM reads");
+  sampler_set_work(&smp, 2.0 * reps, 0);
+  sampler_report(&smp);
   
   printf("Finished %lu RAM reads.\n\n", (2 * reps));
     
   return 0;
 }
 
-/* allocate 'size' amount of memory (in MB)        */
+/* allocate 'nbytes' bytes of memory per thread   */
 /* write a random value to all the array elements  */
 /* in a contiguous manner and then free the memory. */
-int mem_write_contig(unsigned int size){
+int mem_write_contig(size_t nbytes){
   
-  int i;
-  /* work out number of bytes from size in MB */
-  int nbytes = size * 1048576; 
+  size_t i;
+  char buf[32];
   /* work out number of ints that fit into nbytes */
-  int nelements = nbytes / sizeof(int); 
+  size_t nelements = nbytes / sizeof(int); 
 
   double oh, rt;
+  char title[96];
 
-  struct timespec start, end;
-  
-  srand((int)time(NULL));
+  sampler_t smp;
   
-  int data = rand();
+  int data = (int)rng_next(rng_thread());
 
   int nthreads;
   # pragma omp parallel
   if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
 
-  int **arrays = (int **)malloc(nthreads * sizeof(int*));
+  /* one array of nbytes per thread, placed according to --numa */
+  int **arrays = numa_alloc_arrays(nthreads, nbytes, 0, 0);
   if (!arrays) {
       printf("Out of memory.\n");
       return 0;
   }
   
-  /* allocate array of nbytes for each thread */
-  for (i = 0; i < nthreads; i++) {
-      arrays[i] = (int *)malloc(nbytes);
-      if (!arrays[i]) {
-	  printf("Out of memory.\n");
-	  return 0;
-      }
-  }
-  
   /* loop overhead */
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  for(i = 0; i < nelements; i++){
-    __asm__ ("nop");
+  sampler_init(&smp, "Loop overhead for contiguous write");
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+      sampler_thread_start(&smp);
+      for(i = 0; i < nelements; i++){
+        __asm__ ("nop");
+      }
+      sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  oh = elapsed_time_hr(start, end, "Loop overhead for contiguous write");
-
+  oh = sampler_report(&smp);
 
-  clock_gettime(CLOCK, &start);
-
-  # pragma omp parallel private(i)
-  {
-      int *array = arrays[omp_get_thread_num()];
 
-      /* write data to array in contiguous manner - loop over i */
-      for(i = 0; i < nelements; i++){
-	  array[i] = data;
-      }
+  sprintf(title, "Write contiguously%s%s", simd_nt ? ", non-temporal" : "", simd_cold ? ", cold cache" : "");
+  sampler_init(&smp, title);
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        int *array = arrays[omp_get_thread_num()];
+        if (simd_cold) simd_flush(array, nbytes);
+        sampler_thread_start(&smp);
+
+        /* write data to array in contiguous manner - loop over i */
+        if (simd_nt) simd_stream_ints(array, nelements, data);
+        else {
+          for(i = 0; i < nelements; i++){
+	      array[i] = data;
+          }
+        }
+        sampler_thread_stop(&smp);
+    }
   }
-  
-  clock_gettime(CLOCK, &end);
-  rt = elapsed_time_hr(start, end, "Write contiguously");
+  sampler_set_work(&smp, (double)nelements * nthreads, (double)nelements * sizeof(int) * nthreads);
+  rt = sampler_report(&smp);
   
   printf("Make sure compiler keeps result: array[0] = %d\n", arrays[0][0]);
 
   printf("Runtime: %f\n", (rt-oh));  
   
-  printf("Finished allocating %d MB memory for %d ints and "
-	 "filling the array in a contiguous manner.\n\n", size, nelements);
+  printf("Finished allocating %s memory for %zu ints and "
+	 "filling the array in a contiguous manner.\n\n", format_bytes(buf, nbytes), nelements);
   
-  for (i = 0; i < nthreads; i++) {
-      free(arrays[i]);
-  }
-  free(arrays); // Remember to free !
+  numa_free_arrays(arrays, nthreads, nbytes);
   /* free(indices); */
 
   return 0;
   
 }
 
-/* allocate 'size' MB of memory, write a random    */
-/* value to all the  array elements in a strided   */
-/* manner and then free the memory.                */
-int mem_write_strided(unsigned int size, unsigned int stride){
+/* allocate 'nbytes' of memory per thread, write  */
+/* a random value to all the  array elements in a  */
+/* strided manner and then free the memory.        */
+int mem_write_strided(size_t nbytes, unsigned int stride){
   
-  int i;
-  int j, s, n = 0;
-  unsigned int nbytes = size * 1048576;
+  size_t i;
+  size_t j, n = 0;
+  unsigned int s;
   unsigned int strbytes = stride * 1024;
+  char buf[32];
 
   /* calculate total number of elements to be allocated/written */
-  unsigned int nelements = nbytes / sizeof(int);
+  size_t nelements = nbytes / sizeof(int);
   /* convert stride size into ints */
   unsigned int str = strbytes / sizeof(int);
 
+  char title[96], ohtitle[64];
   double oh, rt;
 
-  struct timespec start, end;
+  sampler_t smp;
 
   int nthreads;
   # pragma omp parallel
   if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
 
-  srand((int)time(NULL));
-  
-  int data = rand();
+  int data = (int)rng_next(rng_thread());
   
   /* perform the strided write for all stride values */
   /* from 2 up to str                                */
   for(s=2; s<=str; s=s*2){
 
-    /* allocate 'size' MB of memory              */
-    /* get a fresh allocation for each iteration */
-    int **arrays = (int **)malloc(nthreads * sizeof(int*));
+    /* one array of nbytes per thread, placed according to --numa */
+    int **arrays = numa_alloc_arrays(nthreads, nbytes, 0, 0);
     if(arrays == NULL){
       printf("Out Of Memory: could not allocate space for the array.\n");
       return 0;
     }
-    for (i = 0; i < nthreads; i++) {
-	arrays[i] = (int *)malloc(nbytes);
-	if(arrays[i] == NULL){
-	    printf("Out Of Memory: could not allocate space for the array.\n");
-	    return 0;
-	}
-    }
     
-    printf("Memory size in ints: %d, stride in ints: %d\n", nelements, s);
+    printf("Memory size in ints: %zu, stride in ints: %u\n", nelements, s);
     
     /* measure the overhead */
-    clock_gettime(CLOCK, &start);
-
-    # pragma omp parallel private(i,j)
-    {
-	int nl = 0;
-	for(i = 0; i < s; i++){
-	    for(j = 0; j < nelements; j=j+s){
-		if(i+j < nelements) {
-		    nl = i+j;
-		}
-		if(nl == nelements-1) break;
-		nl++;
-	    }
-	    if(nl == nelements-1) break;
-	}
-	if (omp_get_thread_num() == 0) n = nl;
-    }
-
-    clock_gettime(CLOCK, &end);
-    oh = elapsed_time_hr(start, end, "Overhead for strided write");
+    sprintf(ohtitle, "Overhead for strided write, stride %u ints", s);
+    sampler_init(&smp, ohtitle);
+    while(sampler_next(&smp)){
+      # pragma omp parallel private(i,j)
+      {
+	  size_t nl = 0;
+	  sampler_thread_start(&smp);
+	  for(i = 0; i < s; i++){
+	      for(j = 0; j < nelements; j=j+s){
+		  if(i+j < nelements) {
+		      nl = i+j;
+		  }
+		  if(nl == nelements-1) break;
+		  nl++;
+	      }
+	      if(nl == nelements-1) break;
+	  }
+	  if (omp_get_thread_num() == 0) n = nl;
+	  sampler_thread_stop(&smp);
+      }
+    }
+    oh = sampler_report(&smp);
 
     /* make sure the compiler executes the loop that calculates n */
-    printf("n = %d\n", n);
+    printf("n = %zu\n", n);
 
     n = 0;
     
-    clock_gettime(CLOCK, &start);
-
-    
-    /* write data to array in strided manner */
-    # pragma omp parallel private(i,j)
-    {
-	int *array = arrays[omp_get_thread_num()];
-	int nl = 0;
-	for(i = 0; i < s; i++){
-	    for(j = 0; j < nelements; j=j+s){
-		if(i+j < nelements) {
-		    nl = i+j;
-		    array[nl]=data;
-		}
-		if(nl == nelements-1) break;
-		nl++;
-	    }
-	    if(nl == nelements-1) break;
-	}
-	if (omp_get_thread_num() == 0) n = nl;
+    sprintf(title, "Strided write, stride %u ints%s%s", s,
+	    simd_nt ? ", non-temporal" : "", simd_cold ? ", cold cache" : "");
+    sampler_init(&smp, title);
+    while(sampler_next(&smp)){
+      /* write data to array in strided manner */
+      # pragma omp parallel private(i,j)
+      {
+	  int *array = arrays[omp_get_thread_num()];
+	  size_t nl = 0;
+	  /* a local copy, stores to array could otherwise alias simd_nt */
+	  int nt = simd_nt;
+	  if (simd_cold) simd_flush(array, nbytes);
+	  sampler_thread_start(&smp);
+	  for(i = 0; i < s; i++){
+	      for(j = 0; j < nelements; j=j+s){
+		  if(i+j < nelements) {
+		      nl = i+j;
+		      if (nt) simd_stream_int(&array[nl], data);
+		      else array[nl]=data;
+		  }
+		  if(nl == nelements-1) break;
+		  nl++;
+	      }
+	      if(nl == nelements-1) break;
+	  }
+	  if (nt) simd_store_fence();
+	  if (omp_get_thread_num() == 0) n = nl;
+	  sampler_thread_stop(&smp);
+      }
     }
-    
-    clock_gettime(CLOCK, &end);
-    rt = elapsed_time_hr(start, end, "Strided write");
+    sampler_set_work(&smp, (double)nelements * nthreads, (double)nelements * sizeof(int) * nthreads);
+    rt = sampler_report(&smp);
     
     /* make sure the compiler executes the loop that calculates n */
-    printf("n = %d, array[0] = %d\n", n, arrays[0][0]);
+    printf("n = %zu, array[0] = %d\n", n, arrays[0][0]);
 
     printf("Runtime: %f\n", (rt-oh));  
   
-    for (i = 0; i < nthreads; i++) {
-	free(arrays[i]);
-    }
-    free(arrays); // Remember to free !
+    numa_free_arrays(arrays, nthreads, nbytes);
   
   }
 
-  printf("Finished allocating %d MB memory and "
+  printf("Finished allocating %s memory and "
 	 "filling the array in a strided manner "
-	 "up to a stride size of %d KB.\n\n", size, stride);
+	 "up to a stride size of %d KB.\n\n", format_bytes(buf, nbytes), stride);
       
   return 0;
   
 }
 
-/* allocate memory for 'size' number of elements   */
-/* of type 'dt', write a random value to all the   */
-/* array elements using random access and then     */
-/* free the memory.                                */
-int mem_write_random(unsigned int size){
+/* allocate 'nbytes' of memory per thread, write  */
+/* a random value to all the array elements using  */
+/* random access and then free the memory.         */
+int mem_write_random(size_t nbytes){
   
-  int i, n;
-  unsigned int t;
-  /* work out number of bytes from size in MB */
-  int nbytes = size * 1048576;
+  size_t i, n;
+  char buf[32];
   /* work out number of ints that fit into nbytes */
-  int nelements = nbytes / sizeof(int);
+  size_t nelements = nbytes / sizeof(int);
 
   double oh, rt = 0.0;
 
-  struct timespec start, end;
-  
-  t = (int)time(NULL);
+  sampler_t smp;
 
   int nthreads;
   # pragma omp parallel
   if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
 
-  /* allocate 'size' MB of memory per thread */
-  int **arrays = (int **)malloc(nthreads * sizeof(int*));
+  /* one array of nbytes per thread, placed according to --numa */
+  int **arrays = numa_alloc_arrays(nthreads, nbytes, 0, 0);
   if(arrays == NULL){
     printf("Out Of Memory: could not allocate space for the array.\n");
     return 0;
   }
-  for (i = 0; i < nthreads; i++) {
-      arrays[i] = (int *)malloc(nbytes);
-      if(arrays[i] == NULL){
-	  printf("Out Of Memory: could not allocate space for the array.\n");
-	  return 0;
-      }
-  }
-
-  srand(t);
 
-  clock_gettime(CLOCK, &start);
-
-
-  /* measure overheads */
-  # pragma omp parallel private(i)
-  {
-      int ln;
-      for(i=0; i<nelements; i++){
-	  ln = rand() % (nelements);
-      }
-      n = ln;
+  /* with --precompute the indices are drawn before timing */
+  size_t **idx = NULL;
+  if (rng_precompute) {
+    idx = rng_index_streams(nthreads, nelements, nelements);
+    if (idx == NULL) {
+      printf("Out Of Memory: could not allocate space for the index streams.\n");
+      numa_free_arrays(arrays, nthreads, nbytes);
+      return 0;
+    }
   }
 
-  clock_gettime(CLOCK, &end);
-  oh = elapsed_time_hr(start, end, "Overhead for random write");
+  sampler_init(&smp, "Overhead for random write");
+  while(sampler_next(&smp)){
+    /* measure overheads */
+    # pragma omp parallel private(i)
+    {
+        size_t ln;
+        rng_t *rng = rng_thread();
+        size_t *stream = idx ? idx[omp_get_thread_num()] : NULL;
+        sampler_thread_start(&smp);
+        if (stream) {
+          for(i=0; i<nelements; i++){
+	      ln = stream[i];
+          }
+        }
+        else {
+          for(i=0; i<nelements; i++){
+	      ln = rng_below(rng, nelements);
+          }
+        }
+        sampler_thread_stop(&smp);
+        if (omp_get_thread_num() == 0) n = ln;
+    }
+  }
+  oh = sampler_report(&smp);
 
-  printf("Keep result: n = %d\n", n);  
+  printf("Keep result: n = %zu\n", n);  
   
-  srand(t);
-  int data = rand();
+  int data = (int)rng_next(rng_thread());
 
-  clock_gettime(CLOCK, &start);
-  
-  
-  /* write data to array in random manner */
-  # pragma omp parallel private(i, n)
-  {
-      int *array = arrays[omp_get_thread_num()];
-      for(i = 0; i < nelements; i++){
-	  n = rand() % (nelements);
-	  array[n] = data;
-      }
+  sampler_init(&smp, "Write random");
+  while(sampler_next(&smp)){
+    /* write data to array in random manner */
+    # pragma omp parallel private(i, n)
+    {
+        int *array = arrays[omp_get_thread_num()];
+        rng_t *rng = rng_thread();
+        size_t *stream = idx ? idx[omp_get_thread_num()] : NULL;
+        sampler_thread_start(&smp);
+        if (stream) {
+          for(i = 0; i < nelements; i++){
+	      array[stream[i]] = data;
+          }
+        }
+        else {
+          for(i = 0; i < nelements; i++){
+	      n = rng_below(rng, nelements);
+	      array[n] = data;
+          }
+        }
+        sampler_thread_stop(&smp);
+    }
   }
-    
-  clock_gettime(CLOCK, &end);
-  rt = elapsed_time_hr(start, end, "Write random");
+  sampler_set_work(&smp, (double)nelements * nthreads, (double)nelements * sizeof(int) * nthreads);
+  rt = sampler_report(&smp);
 
   printf("Runtime: %f\n", (rt-oh));
   
-  printf("Finished allocating %d MB memory (%d ints) and "
-	 "filling the array in a random manner.\n\n", size, nelements);
+  printf("Finished allocating %s memory (%zu ints) and "
+	 "filling the array in a random manner.\n\n", format_bytes(buf, nbytes), nelements);
 
-  for (i = 0; i < nthreads; i++) {
-      free(arrays[i]);
-  }
-  free(arrays); // Remember to free !
+  numa_free_arrays(arrays, nthreads, nbytes);
+  rng_free_streams(idx, nthreads);
 
   return 0;
   
 }
 
 
-/* allocate 'size' amount of memory (in MB)        */
+/* allocate 'nbytes' bytes of memory per thread   */
 /* write a random value to all the array elements  */
 /* in a contiguous manner, read back from memory   */
 /* and, finally, free the memory.                  */
-int mem_read_contig(unsigned int size){
+int mem_read_contig(size_t nbytes){
   
-    int i, j, n;
-  /* work out number of bytes from size in MB */
-  int nbytes = size * 1048576; 
+  size_t i;
+  char buf[32];
   /* work out number of ints that fit into nbytes */
-  int nelements = nbytes / sizeof(int); 
+  size_t nelements = nbytes / sizeof(int); 
   
   double oh, rt;
 
-  struct timespec start, end;
-  
-  srand((int)time(NULL));
+  sampler_t smp;
   
-  int data = rand();
+  int data = (int)rng_next(rng_thread());
   int receive = 0;
 
   int nthreads;
   # pragma omp parallel
   if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
 
-  int **arrays = (int **)malloc(nthreads * sizeof(int*));
+  /* one array of nbytes per thread, placed according to --numa */
+  int **arrays = numa_alloc_arrays(nthreads, nbytes, 1, data);
   if (!arrays) {
       printf("Out of memory.\n");
       return 0;
   }
-  
-  /* allocate array of nbytes for each thread */
-  for (i = 0; i < nthreads; i++) {
-      arrays[i] = (int *)malloc(nbytes);
-      if (!arrays[i]) {
-	  printf("Out of memory.\n");
-	  return 0;
-      }
-  }
-  
-  /* populate array with random values */
-  for (j = 0; j < nthreads; j++) {
-      for(i = 0; i < nelements; i++){
-	  arrays[j][i] = data;
-      }
-  }
-
-  clock_gettime(CLOCK, &start);
-
-
-  /* loop overhead */
-  # pragma omp parallel private(i)
-  for(i=0; i<nelements; i++){
-    __asm__ ("nop");
-  }
 
-  clock_gettime(CLOCK, &end);
-  oh = elapsed_time_hr(start, end, "Loop overhead for contiguous read");
-  
-  clock_gettime(CLOCK, &start);
-
-    
-  /* read data back from array */
-  # pragma omp parallel private(i)
-  {
-      int *array = arrays[omp_get_thread_num()];
-      int lreceive;
-      for(i = 0; i < nelements; i++){
-	  lreceive = array[i];
+  sampler_init(&smp, "Loop overhead for contiguous read");
+  while(sampler_next(&smp)){
+    /* loop overhead */
+    # pragma omp parallel private(i)
+    {
+      sampler_thread_start(&smp);
+      for(i=0; i<nelements; i++){
+        __asm__ ("nop");
       }
-      receive = lreceive;
+      sampler_thread_stop(&smp);
+    }
   }
+  oh = sampler_report(&smp);
   
-  clock_gettime(CLOCK, &end);
-  rt = elapsed_time_hr(start, end, "Read contiguously");
+  sampler_init(&smp, simd_cold ? "Read contiguously, cold cache" : "Read contiguously");
+  while(sampler_next(&smp)){
+    /* read data back from array */
+    # pragma omp parallel private(i)
+    {
+        int *array = arrays[omp_get_thread_num()];
+        unsigned int lreceive = 0;
+        if (simd_cold) simd_flush(array, nbytes);
+        sampler_thread_start(&smp);
+        for(i = 0; i < nelements; i++){
+	    lreceive += array[i];
+        }
+        /* summing the loads keeps the compiler from dropping them */
+        if (omp_get_thread_num() == 0) receive = (int)lreceive;
+        sampler_thread_stop(&smp);
+    }
+  }
+  sampler_set_work(&smp, (double)nelements * nthreads, (double)nelements * sizeof(int) * nthreads);
+  rt = sampler_report(&smp);
   
   printf("Keep result: receive = %d\n", receive);
 
   printf("Runtime: %f\n", (rt-oh));  
 
-  printf("Finished reading %d MB memory (%d ints) in a contiguous manner.\n\n", size, nelements);
+  printf("Finished reading %s memory (%zu ints) in a contiguous manner.\n\n", format_bytes(buf, nbytes), nelements);
   
-  for (i = 0; i < nthreads; i++) {
-      free(arrays[i]);
-  }
-  free(arrays); // Remember to free !
+  numa_free_arrays(arrays, nthreads, nbytes);
 
   return 0;
   
 }
 
 
-/* allocate memory for 'size' number of elements   */
-/* of type 'dt', write a random value to all the   */
-/* array elements, read those values back in a     */
-/* strided manner and then free the memory.        */
-int mem_read_strided(unsigned int size, unsigned int stride){
+/* allocate 'nbytes' of memory per thread, write  */
+/* a random value to all the array elements, read  */
+/* those values back in a strided manner and then  */
+/* free the memory.                                */
+int mem_read_strided(size_t nbytes, unsigned int stride){
   
-  int i, j, s, n = 0;
-  /* work out number of bytes from size in MB */
-  unsigned int nbytes = size * 1048576;
+  size_t i, j, n = 0;
+  unsigned int s;
+  char buf[32];
   /* work out number of bytes from stride in KB */
   unsigned int strbytes = stride * 1024;
 
   /* calculate total number of elements to be allocated/read */
-  unsigned int nelements = nbytes / sizeof(int);
+  size_t nelements = nbytes / sizeof(int);
   /* convert stride size into ints */
   unsigned int str = strbytes / sizeof(int);
 
+  char title[96], ohtitle[64];
   double oh, rt = 0.0;
 
-  struct timespec start, end;
+  sampler_t smp;
 
   int nthreads;
   # pragma omp parallel
   if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
 
-  srand((int)time(NULL));
-  
-  int data = rand();
+  int data = (int)rng_next(rng_thread());
   int receive = 0;
 
   /* perform the strided write for all stride values */
   /* from 2 up to str                                */
   for(s=2; s<=str; s=s*2){
 
-    printf("Memory size in ints: %d, stride in ints: %d\n", nelements, s);
+    printf("Memory size in ints: %zu, stride in ints: %u\n", nelements, s);
     
-    /* allocate array of 'size' ints and write data in contiguous manner */
-    /* get a fresh allocation for each iteration */
-    int **arrays = (int **)malloc(nthreads * sizeof(int*));
+    /* one array of nbytes per thread, placed according to --numa */
+    int **arrays = numa_alloc_arrays(nthreads, nbytes, 1, data);
     if(arrays == NULL){
       printf("Out Of Memory: could not allocate space for the array.\n");
       return 0;
     }
-    for (i = 0; i < nthreads; i++) {
-	arrays[i] = (int *)malloc(nbytes);
-	if(arrays[i] == NULL){
-	    printf("Out Of Memory: could not allocate space for the array.\n");
-	    return 0;
-	}
-    }
-    
-    /* fill array with data - no need for striding here */  
-    for (j = 0; j < nthreads; j++) {
-	for(i = 0; i < nelements; i++){
-	    arrays[j][i] = data;
-	}
-    }
 
-    clock_gettime(CLOCK, &start);
-
-    
-    /* measure the overhead */
-    # pragma omp parallel private(i, j)
-    {
-	int nl = 0;
-	for(i = 0; i < s; i++){
-	    for(j = 0; j < nelements; j=j+s){
-		if(i+j < nelements){
-		    nl = i+j;
-		}
-		if(nl == nelements-1) break;
-		nl++;
-	    }
-	    if(nl == nelements-1) break;
-	}
-	n = nl;
+    sprintf(ohtitle, "Overhead for strided read, stride %u ints", s);
+    sampler_init(&smp, ohtitle);
+    while(sampler_next(&smp)){
+      /* measure the overhead */
+      # pragma omp parallel private(i, j)
+      {
+	  size_t nl = 0;
+	  sampler_thread_start(&smp);
+	  for(i = 0; i < s; i++){
+	      for(j = 0; j < nelements; j=j+s){
+		  if(i+j < nelements){
+		      nl = i+j;
+		  }
+		  if(nl == nelements-1) break;
+		  nl++;
+	      }
+	      if(nl == nelements-1) break;
+	  }
+	  n = nl;
+	  sampler_thread_stop(&smp);
+      }
     }
-    
-    clock_gettime(CLOCK, &end);
-    oh = elapsed_time_hr(start, end, "Overhead for strided read");
+    oh = sampler_report(&smp);
     
     /* make sure the compiler executes the loop that calculates n */
-    printf("n = %d\n", n);
+    printf("n = %zu\n", n);
     
-    clock_gettime(CLOCK, &start);
-
-    
-    /* read data from array following strided pattern */  
-    # pragma omp parallel private(i, j)
-    {
-	int nl = 0;
-	int *array = arrays[omp_get_thread_num()];
-	for(i = 0; i < s; i++){
-	    for(j = 0; j < nelements; j=j+s){
-		if(i+j < nelements){
-		    nl = i+j;
-		    receive = array[nl];
-		}
-		if(nl == nelements-1) break;
-		nl++;
-	    }
-	    if(nl == nelements-1) break;
-	}
-	n = nl;
+    sprintf(title, "Read strided, stride %u ints%s", s, simd_cold ? ", cold cache" : "");
+    sampler_init(&smp, title);
+    while(sampler_next(&smp)){
+      /* read data from array following strided pattern */  
+      # pragma omp parallel private(i, j)
+      {
+	  size_t nl = 0;
+	  unsigned int lreceive = 0;
+	  int *array = arrays[omp_get_thread_num()];
+	  if (simd_cold) simd_flush(array, nbytes);
+	  sampler_thread_start(&smp);
+	  for(i = 0; i < s; i++){
+	      for(j = 0; j < nelements; j=j+s){
+		  if(i+j < nelements){
+		      nl = i+j;
+		      lreceive += array[nl];
+		  }
+		  if(nl == nelements-1) break;
+		  nl++;
+	      }
+	      if(nl == nelements-1) break;
+	  }
+	  n = nl;
+	  /* summing the loads keeps the compiler from dropping them */
+	  if (omp_get_thread_num() == 0) receive = (int)lreceive;
+	  sampler_thread_stop(&smp);
+      }
     }
-    
-    clock_gettime(CLOCK, &end);
-    rt = elapsed_time_hr(start, end, "Read strided");
+    sampler_set_work(&smp, (double)nelements * nthreads, (double)nelements * sizeof(int) * nthreads);
+    rt = sampler_report(&smp);
     
     /* make sure the compiler executes the loop that calculates n */
-    printf("n = %d, receive = %d\n", n, receive);
+    printf("n = %zu, receive = %d\n", n, receive);
     
     printf("Runtime: %f\n", (rt-oh));
     
-    for (i = 0; i < nthreads; i++) {
-	free(arrays[i]);
-    }
-    free(arrays); // Remember to free !
+    numa_free_arrays(arrays, nthreads, nbytes);
   }    
   
-  printf("Finished allocating %d MB memory and "
+  printf("Finished allocating %s memory and "
 	 "reading the array in a strided manner "
-	 "with a stride size of %d KB.\n\n", size, stride);
+	 "with a stride size of %d KB.\n\n", format_bytes(buf, nbytes), stride);
 
   return 0;
   
 }
 
-/* allocate memory for 'size' number of elements   */
-/* of type 'dt', write a random value to all the   */
-/* array elements, read those values back in a     */
-/* random manner and then free the memory.        */
-int mem_read_random(unsigned int size){
+/* allocate 'nbytes' of memory per thread, write  */
+/* a random value to all the array elements, read  */
+/* those values back in a random manner and then   */
+/* free the memory.                                */
+int mem_read_random(size_t nbytes){
   
-    int i, j, n;
-  unsigned int t;
+  size_t i, n;
+  char buf[32];
 
   double oh, rt;
 
-  /* work out number of bytes from size in MB */
-  unsigned int nbytes = size * 1048576;
   /* calculate total number of elements to be allocated/read */
-  unsigned int nelements = nbytes / sizeof(int);
-  
-  struct timespec start, end;
+  size_t nelements = nbytes / sizeof(int);
   
-  t =(int)time(NULL);
+  sampler_t smp;
 
   int nthreads;
   # pragma omp parallel
   if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
 
-  int data = rand();
+  int data = (int)rng_next(rng_thread());
   int receive = 0;
   
-  /* allocate array of 'size' ints and write data in contiguous manner */
-  int **arrays = (int **)malloc(nthreads * sizeof(int*));
+  /* one array of nbytes per thread, placed according to --numa */
+  int **arrays = numa_alloc_arrays(nthreads, nbytes, 1, data);
   if(arrays == NULL){
     printf("Out Of Memory: could not allocate space for the array.\n");
     return 0;
   }
-  for (i = 0; i < nthreads; i++) {
-      arrays[i] = (int *)malloc(nbytes);
-      if(arrays[i] == NULL){
-	  printf("Out Of Memory: could not allocate space for the array.\n");
-	  return 0;
-      }
+
+  /* with --precompute the indices are drawn before timing */
+  size_t **idx = NULL;
+  if (rng_precompute) {
+    idx = rng_index_streams(nthreads, nelements, nelements);
+    if (idx == NULL) {
+      printf("Out Of Memory: could not allocate space for the index streams.\n");
+      numa_free_arrays(arrays, nthreads, nbytes);
+      return 0;
+    }
   }
+
+  /* measure the overhead */
+  sampler_init(&smp, "Overhead for random read");
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        size_t nl;
+        rng_t *rng = rng_thread();
+        size_t *stream = idx ? idx[omp_get_thread_num()] : NULL;
+        sampler_thread_start(&smp);
+        if (stream) {
+          for(i=0; i<nelements; i++){
+	      nl = stream[i];
+          }
+        }
+        else {
+          for(i=0; i<nelements; i++){
+	      nl = rng_below(rng, nelements);
+          }
+        }
+        sampler_thread_stop(&smp);
+        if (omp_get_thread_num() == 0) n = nl;
+    }
+  }
+  oh = sampler_report(&smp);
   
-  /* fill the array with random values */
-  for (j = 0; j < nthreads; j++) {
-      for(i = 0; i < nelements; i++){
-	  arrays[j][i] = data;
+  printf("Make sure the result is kept: %zu\n", n);
+
+  /* measure the random reads */
+  sampler_init(&smp, "Read random");
+  while(sampler_next(&smp)){
+    # pragma omp parallel private(i)
+    {
+        unsigned int receivel = 0;
+        size_t nl;
+        int *array = arrays[omp_get_thread_num()];
+        rng_t *rng = rng_thread();
+        size_t *stream = idx ? idx[omp_get_thread_num()] : NULL;
+        sampler_thread_start(&smp);
+        if (stream) {
+          for(i = 0; i < nelements; i++){
+	      receivel += array[stream[i]];
+          }
+        }
+        else {
+          for(i = 0; i < nelements; i++){
+	      nl = rng_below(rng, nelements);
+	      receivel += array[nl];
+          }
+        }
+        /* summing the loads keeps the compiler from dropping them */
+        if (omp_get_thread_num() == 0) receive = (int)receivel;
+        sampler_thread_stop(&smp);
+    }
+  }
+  sampler_set_work(&smp, (double)nelements * nthreads, (double)nelements * sizeof(int) * nthreads);
+  rt = sampler_report(&smp);
+  
+  printf("Make sure the result is kept: %d\n", receive);
+
+  printf("Runtime: %f\n", (rt-oh));
+
+  printf("Finished reading %s of memory (%zu ints) in a random manner.\n\n", format_bytes(buf, nbytes), nelements);
+  
+  numa_free_arrays(arrays, nthreads, nbytes);
+  rng_free_streams(idx, nthreads);
+
+  return 0;
+  
+}
+
+
+/* lists of strides and element sizes for the stride sweep, NULL for the defaults */
+char *mem_strides = NULL;
+char *mem_elements = NULL;
+
+#define STRIDE_MAX 64
+
+/* element types of the stride sweep, 16 and 64 byte elements are several words */
+typedef struct { unsigned long long w[2]; } elem16_t;
+typedef struct { unsigned long long w[8]; } elem64_t;
+
+/*
+ * Strided kernels over nbytes of buf: the outer loop walks the offsets
+ * within one stride and the inner loop strides through the array from
+ * each offset, so every element is touched exactly once per call and no
+ * bounds test or break is left in the inner loop.
+ */
+#define STRIDE_KERNELS(T, NAME, LOAD, STORE)                                     \
+static unsigned long long stride_read_##NAME(char *buf, size_t nbytes, size_t stride){ \
+  unsigned long long sum = 0;                                                    \
+  size_t o, p;                                                                   \
+  for (o = 0; o < stride; o += sizeof(T)) {                                      \
+    for (p = o; p + sizeof(T) <= nbytes; p += stride) {                          \
+      T *e = (T *)(buf + p);                                                     \
+      sum += LOAD;                                                               \
+    }                                                                            \
+  }                                                                              \
+  return sum;                                                                    \
+}                                                                                \
+static void stride_write_##NAME(char *buf, size_t nbytes, size_t stride, unsigned long long v){ \
+  size_t o, p;                                                                   \
+  for (o = 0; o < stride; o += sizeof(T)) {                                      \
+    for (p = o; p + sizeof(T) <= nbytes; p += stride) {                          \
+      T *e = (T *)(buf + p);                                                     \
+      STORE;                                                                     \
+    }                                                                            \
+  }                                                                              \
+}
+
+STRIDE_KERNELS(unsigned char, 1, *e, *e = (unsigned char)v)
+STRIDE_KERNELS(unsigned int, 4, *e, *e = (unsigned int)v)
+STRIDE_KERNELS(unsigned long long, 8, *e, *e = v)
+STRIDE_KERNELS(elem16_t, 16, e->w[0] + e->w[1],
+               e->w[0] = v; e->w[1] = v)
+STRIDE_KERNELS(elem64_t, 64, e->w[0] + e->w[1] + e->w[2] + e->w[3] + e->w[4] + e->w[5] + e->w[6] + e->w[7],
+               e->w[0] = v; e->w[1] = v; e->w[2] = v; e->w[3] = v; e->w[4] = v; e->w[5] = v; e->w[6] = v; e->w[7] = v)
+
+static unsigned long long stride_pass(int write, size_t esize, char *buf, size_t nbytes, size_t stride, unsigned long long v){
+
+  switch (esize) {
+  case 1:
+    if (write) stride_write_1(buf, nbytes, stride, v);
+    else return stride_read_1(buf, nbytes, stride);
+    break;
+  case 4:
+    if (write) stride_write_4(buf, nbytes, stride, v);
+    else return stride_read_4(buf, nbytes, stride);
+    break;
+  case 8:
+    if (write) stride_write_8(buf, nbytes, stride, v);
+    else return stride_read_8(buf, nbytes, stride);
+    break;
+  case 16:
+    if (write) stride_write_16(buf, nbytes, stride, v);
+    else return stride_read_16(buf, nbytes, stride);
+    break;
+  default:
+    if (write) stride_write_64(buf, nbytes, stride, v);
+    else return stride_read_64(buf, nbytes, stride);
+    break;
+  }
+
+  return 0;
+}
+
+/* read or write (write set) nbytes per thread with every element */
+/* size of --elements at every stride of --strides, by default    */
+/* ints at powers of two and their midpoints up to 'stride' KB.   */
+int mem_stride_sweep(size_t nbytes, unsigned int stride, int write){
+
+  size_t strides[STRIDE_MAX], esizes[STRIDE_MAX], st;
+  double gbs[STRIDE_MAX][STRIDE_MAX];
+  int nstrides = 0, nesizes, k, e;
+  unsigned long reps;
+  unsigned long long total = 0;
+  char title[128], buf[32], sbuf[32];
+
+  sampler_t smp;
+
+  int nthreads;
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  if (mem_elements) nesizes = parse_size_list(mem_elements, "element size", esizes, STRIDE_MAX);
+  else {
+    esizes[0] = sizeof(int);
+    nesizes = 1;
+  }
+  for (e = 0; e < nesizes; e++) {
+    if (esizes[e] != 1 && esizes[e] != 4 && esizes[e] != 8 && esizes[e] != 16 && esizes[e] != 64) {
+      fprintf(stderr, "ERROR: element sizes have to be 1, 4, 8, 16 or 64 bytes\n");
+      return 0;
+    }
+  }
+
+  if (mem_strides) nstrides = parse_size_list(mem_strides, "stride", strides, STRIDE_MAX);
+  else {
+    for (st = 64; st <= (size_t)stride * 1024 && nstrides < STRIDE_MAX - 1; st *= 2) {
+      strides[nstrides++] = st;
+      if (st + st / 2 <= (size_t)stride * 1024) strides[nstrides++] = st + st / 2;
+    }
+  }
+  if (nesizes == 0 || nstrides == 0) {
+    fprintf(stderr, "ERROR: check the lists given to --strides and --elements...\n");
+    return 0;
+  }
+
+  /* one array of nbytes per thread, placed according to --numa */
+  int **arrays = numa_alloc_arrays(nthreads, nbytes, 1, 1);
+  if (arrays == NULL) {
+    printf("Out Of Memory: could not allocate space for the array.\n");
+    return 0;
+  }
+
+  for (e = 0; e < nesizes; e++) {
+    for (k = 0; k < nstrides; k++) {
+
+      gbs[e][k] = -1.0;
+      /* elements must not straddle two strides */
+      if (strides[k] % esizes[e] != 0) {
+        printf("Skipping stride %zu B, it is not a multiple of the %zu B element.\n", strides[k], esizes[e]);
+        continue;
+      }
+
+      sprintf(title, "Strided %s, %zu B elements, stride %zu B", write ? "write" : "read",
+              esizes[e], strides[k]);
+      reps = 0;
+      sampler_init(&smp, title);
+      sampler_calibrate(&smp, &reps);
+      while(sampler_next(&smp)){
+        # pragma omp parallel reduction(+:total)
+        {
+            char *array = (char *)arrays[omp_get_thread_num()];
+            unsigned long j;
+            sampler_thread_start(&smp);
+            for (j = 0; j < reps; j++) {
+                total += stride_pass(write, esizes[e], array, nbytes, strides[k], j);
+            }
+            sampler_thread_stop(&smp);
+        }
       }
+      sampler_set_work(&smp, (double)reps * (nbytes / esizes[e]) * nthreads,
+                       (double)reps * (nbytes / esizes[e]) * esizes[e] * nthreads);
+      gbs[e][k] = (double)reps * (nbytes / esizes[e]) * esizes[e] * nthreads / sampler_report(&smp) / 1e9;
+    }
   }
 
-  srand(t);
+  printf("\nStrided %s bandwidth (GB/s, all threads) over %s per thread:\n", write ? "write" : "read",
+         format_bytes(buf, nbytes));
+  printf("  %10s", "stride B");
+  for (e = 0; e < nesizes; e++) {
+    sprintf(sbuf, "%zu B", esizes[e]);
+    printf("  %10s", sbuf);
+  }
+  printf("\n");
+  for (k = 0; k < nstrides; k++) {
+    printf("  %10zu", strides[k]);
+    for (e = 0; e < nesizes; e++) {
+      if (gbs[e][k] >= 0.0) printf("  %10.3f", gbs[e][k]);
+      else printf("  %10s", "-");
+    }
+    printf("\n");
+  }
+  printf("Keep result: %llu %d\n\n", total, arrays[0][0]);
 
-  /* measure the overhead */
-  clock_gettime(CLOCK, &start);
+  numa_free_arrays(arrays, nthreads, nbytes);
+
+  return 0;
+}
+
+
+/* replay the --trace pattern or trace file against one array of 'nbytes' */
+/* of 8 byte elements per thread, once with independent accesses for the */
+/* bandwidth and once with every index depending on the previous load    */
+/* for the latency. Every thread replays the same trace on its own array. */
+int mem_trace(size_t nbytes){
+
+  size_t nelements = nbytes / sizeof(unsigned long long);
+  unsigned long long total = 0;
+  unsigned long reps;
+  trace_t tr;
+  char title[128], buf[32];
+  int dep;
+
+  sampler_t smp;
 
-  # pragma omp parallel private(i)
+  int nthreads;
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  if (trace_spec == NULL) {
+    fprintf(stderr, "ERROR: give a trace file or pattern with --trace...\n");
+    return 0;
+  }
+  if (nelements == 0) {
+    fprintf(stderr, "ERROR: the trace benchmark needs a size of at least 8 bytes...\n");
+    return 0;
+  }
+  if (trace_build(trace_spec, nelements, &tr)) return 0;
+  printf("Trace of %zu accesses (%zu writes) over %zu elements.\n", tr.n, tr.writes, nelements);
+  if (trace_out) {
+    if (trace_save(&tr, trace_out) == 0) printf("Trace written to %s.\n", trace_out);
+  }
+
+  /* one array of nbytes per thread, placed according to --numa; it stays */
+  /* zero, so adding a loaded value to the next index leaves it unchanged */
+  unsigned long long **arrays = (unsigned long long **)numa_alloc_arrays(nthreads, nbytes, 1, 0);
+  if (arrays == NULL) {
+    printf("Out Of Memory: could not allocate space for the array.\n");
+    trace_free(&tr);
+    return 0;
+  }
+
+  for (dep = 0; dep < 2; dep++) {
+
+    sprintf(title, "Trace replay%s, %s per thread", dep ? ", dependent" : "", format_bytes(buf, nbytes));
+    reps = 0;
+    sampler_init(&smp, title);
+    sampler_calibrate(&smp, &reps);
+    while(sampler_next(&smp)){
+      # pragma omp parallel reduction(+:total)
+      {
+          unsigned long long *a = arrays[omp_get_thread_num()];
+          unsigned long long *idx = tr.idx, x, sum = 0, last = 0;
+          size_t i, n = tr.n;
+          unsigned long j;
+          sampler_thread_start(&smp);
+          for (j = 0; j < reps; j++) {
+              if (dep) {
+                  for (i = 0; i < n; i++) {
+                      x = idx[i];
+                      if (x & TRACE_WRITE) a[(x & ~TRACE_WRITE) + last] = last;
+                      else last = a[x + last];
+                  }
+              }
+              else {
+                  for (i = 0; i < n; i++) {
+                      x = idx[i];
+                      if (x & TRACE_WRITE) a[x & ~TRACE_WRITE] = 0;
+                      else sum += a[x];
+                  }
+              }
+          }
+          sampler_thread_stop(&smp);
+          total += sum + last;
+      }
+    }
+    sampler_set_work(&smp, (double)reps * tr.n * nthreads, (double)reps * tr.n * sizeof(unsigned long long) * nthreads);
+    if (dep) sampler_set_latency(&smp, (double)reps * tr.n);
+    sampler_report(&smp);
+  }
+  printf("Keep result: %llu\n\n", total);
+
+  numa_free_arrays((int **)arrays, nthreads, nbytes);
+  trace_free(&tr);
+
+  return 0;
+}
+
+
+/* index localities of the gather and scatter benchmarks, NULL for all */
+char *mem_locality = NULL;
+
+#define LOCALITY_MAX 16
+
+static int cmp_uint(const void *x, const void *y){
+  unsigned int a = *(const unsigned int *)x, b = *(const unsigned int *)y;
+  return (a > b) - (a < b);
+}
+
+/*
+ * Fill idx with n indices below n of the named locality: sorted random
+ * indices, blocks of 'param' consecutive indices in random block order,
+ * uniformly random indices, or random indices of which a fraction
+ * 'param' repeats one of the previous eight. Returns 1 if unknown.
+ */
+static int fill_indices(char *loc, double param, unsigned int *idx, size_t n, rng_t *rng){
+
+  size_t i, j, k, b, nb;
+
+  if (strcmp(loc, "sorted") == 0) {
+    for (i = 0; i < n; i++) idx[i] = (unsigned int)rng_below(rng, n);
+    qsort(idx, n, sizeof(unsigned int), cmp_uint);
+  }
+  else if (strcmp(loc, "blocked") == 0) {
+    b = param > 0 ? (size_t)param : 64;
+    nb = (n + b - 1) / b;
+    /* shuffle the block numbers into the first nb slots, then expand from the back */
+    for (i = 0; i < nb; i++) idx[i] = (unsigned int)i;
+    for (i = nb - 1; i > 0; i--) {
+      k = rng_below(rng, i + 1);
+      j = idx[i]; idx[i] = idx[k]; idx[k] = (unsigned int)j;
+    }
+    for (i = nb; i-- > 0;) {
+      size_t base = (size_t)idx[i] * b;
+      for (j = b; j-- > 0;) {
+        if (i * b + j < n) idx[i * b + j] = (unsigned int)((base + j) % n);
+      }
+    }
+  }
+  else if (strcmp(loc, "random") == 0) {
+    for (i = 0; i < n; i++) idx[i] = (unsigned int)rng_below(rng, n);
+  }
+  else if (strcmp(loc, "dup") == 0) {
+    unsigned long long cut = (unsigned long long)((param > 0 ? param : 0.5) * 4294967296.0);
+    for (i = 0; i < n; i++) {
+      if (i > 0 && (rng_next(rng) >> 32) < cut) idx[i] = idx[i - 1 - rng_below(rng, i < 8 ? i : 8)];
+      else idx[i] = (unsigned int)rng_below(rng, n);
+    }
+  }
+  else return 1;
+
+  return 0;
+}
+
+/* gather (sum a[idx[i]]) or scatter (a[idx[i]] = v) over per-thread */
+/* arrays of 'nbytes' of doubles with one index per element, for each */
+/* index locality of --locality and each hardware gather or scatter   */
+/* width, next to a pass over the index stream alone.                 */
+int mem_indirect(size_t nbytes, int scatter){
+
+  size_t nelements = nbytes / sizeof(double);
+  char *locs[LOCALITY_MAX], *copy, *tok, *arg;
+  double params[LOCALITY_MAX], gbs[LOCALITY_MAX][4], tidx, useful;
+  int widths[4];
+  int nlocs = 0, nwidths, l, w, bad = 0;
+  unsigned long reps;
+  double total = 0.0;
+  char title[128], wname[32];
+
+  sampler_t smp;
+
+  int nthreads;
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  if (nelements == 0 || nelements > UINT_MAX) {
+    fprintf(stderr, "ERROR: the %s benchmark needs between 8 bytes and 32 GB per thread...\n", scatter ? "scatter" : "gather");
+    return 0;
+  }
+
+  copy = strdup(mem_locality ? mem_locality : "sorted,blocked,random,dup");
+  if (!copy) return 0;
+  for (tok = strtok(copy, ","); tok && nlocs < LOCALITY_MAX; tok = strtok(NULL, ",")) {
+    arg = strchr(tok, ':');
+    if (arg) *arg++ = '\0';
+    locs[nlocs] = tok;
+    params[nlocs++] = arg ? atof(arg) : 0.0;
+  }
+
+  nwidths = simd_gather_widths(widths, scatter);
+  /* the hardware gathers and scatters take signed 32-bit indices */
+  if (nelements > INT_MAX) nwidths = (widths[0] == SIMD_SCALAR);
+  if (nwidths == 0) {
+    fprintf(stderr, "ERROR: no hardware %s of the requested width%s...\n", scatter ? "scatter" : "gather",
+            nelements > INT_MAX ? " for arrays over 16 GB per thread" : "");
+    free(copy);
+    return 0;
+  }
+
+  /* per thread one data array and one index array, placed according to --numa */
+  double **a = (double **)numa_alloc_arrays(nthreads, nbytes, 1, 0);
+  unsigned int **ix = (unsigned int **)numa_alloc_arrays(nthreads, nelements * sizeof(unsigned int), 0, 0);
+  if (!a || !ix) {
+    printf("Out Of Memory: could not allocate space for the arrays.\n");
+    numa_free_arrays((int **)a, nthreads, nbytes);
+    numa_free_arrays((int **)ix, nthreads, nelements * sizeof(unsigned int));
+    free(copy);
+    return 0;
+  }
+
+  /* the index stream on its own: a contiguous read of 4 byte indices */
+  # pragma omp parallel
+  fill_indices("random", 0.0, ix[omp_get_thread_num()], nelements, rng_thread());
+  reps = 0;
+  sampler_init(&smp, "Index stream only");
+  sampler_calibrate(&smp, &reps);
+  while(sampler_next(&smp)){
+    # pragma omp parallel reduction(+:total)
+    {
+        unsigned int *idx = ix[omp_get_thread_num()];
+        unsigned long long sum = 0;
+        unsigned long j;
+        size_t i;
+        sampler_thread_start(&smp);
+        for (j = 0; j < reps; j++) {
+            for (i = 0; i < nelements; i++) sum += idx[i];
+        }
+        sampler_thread_stop(&smp);
+        total += (double)sum;
+    }
+  }
+  sampler_set_work(&smp, (double)reps * nelements * nthreads, (double)reps * nelements * sizeof(unsigned int) * nthreads);
+  tidx = sampler_report(&smp) / reps;
+
+  for (l = 0; l < nlocs; l++) {
+
+    # pragma omp parallel reduction(+:bad)
+    bad += fill_indices(locs[l], params[l], ix[omp_get_thread_num()], nelements, rng_thread());
+    if (bad) {
+      fprintf(stderr, "ERROR: unknown index locality %s, use sorted, blocked[:B], random or dup[:P]\n", locs[l]);
+      break;
+    }
+
+    for (w = 0; w < nwidths; w++) {
+
+      if (widths[w] == SIMD_SCALAR) sprintf(wname, "scalar");
+      else sprintf(wname, "%d-bit hardware %s", widths[w], scatter ? "scatter" : "gather");
+      sprintf(title, "%s, %s indices, %s", scatter ? "Scatter" : "Gather", locs[l], wname);
+      reps = 0;
+      sampler_init(&smp, title);
+      sampler_calibrate(&smp, &reps);
+      while(sampler_next(&smp)){
+        # pragma omp parallel reduction(+:total)
+        {
+            int t = omp_get_thread_num();
+            unsigned long j;
+            sampler_thread_start(&smp);
+            for (j = 0; j < reps; j++) {
+                if (scatter) simd_scatter(widths[w], a[t], ix[t], nelements, (double)j);
+                else total += simd_gather(widths[w], a[t], ix[t], nelements);
+            }
+            sampler_thread_stop(&smp);
+        }
+      }
+      /* only the data elements count as useful bytes */
+      sampler_set_work(&smp, (double)reps * nelements * nthreads, (double)reps * nelements * sizeof(double) * nthreads);
+      gbs[l][w] = sampler_report(&smp) / reps;
+    }
+  }
+
+  if (!bad) {
+    useful = (double)nelements * sizeof(double) * nthreads;
+    printf("\n%s bandwidth in useful data bytes (GB/s, all threads), index stream alone %.3f GB/s:\n",
+           scatter ? "Scatter" : "Gather", (double)nelements * sizeof(unsigned int) * nthreads / tidx / 1e9);
+    printf("  %-10s", "indices");
+    for (w = 0; w < nwidths; w++) {
+      sprintf(wname, "%s", widths[w] == SIMD_SCALAR ? "scalar" : (widths[w] == 256 ? "hw 256" : "hw 512"));
+      printf("  %10s  %10s", wname, "w/o index");
+    }
+    printf("\n");
+    for (l = 0; l < nlocs; l++) {
+      printf("  %-10s", locs[l]);
+      for (w = 0; w < nwidths; w++) {
+        printf("  %10.3f", useful / gbs[l][w] / 1e9);
+        /* data stream alone, taking out the time of the index stream */
+        if (gbs[l][w] > tidx) printf("  %10.3f", useful / (gbs[l][w] - tidx) / 1e9);
+        else printf("  %10s", "-");
+      }
+      printf("\n");
+    }
+    printf("Keep result: %f %f\n\n", total, a[0][0]);
+  }
+
+  numa_free_arrays((int **)a, nthreads, nbytes);
+  numa_free_arrays((int **)ix, nthreads, nelements * sizeof(unsigned int));
+  free(copy);
+
+  return 0;
+}
+
+
+/* size of one link of the pointer chase */
+#define CHASE_LINE 64
+/* cache lines per 4 KB page, the group used by page-aware chasing */
+#define CHASE_PAGE_LINES (4096 / CHASE_LINE)
+
+/*
+ * Link the first 'lines' cache lines of buf into one random cycle and
+ * return its head. Lines are split into groups of 'group' lines: the
+ * groups are visited in random order and the lines of a group in random
+ * order, so with a group of one page every page is finished before the
+ * next is entered and TLB misses stay out of the measurement; a single
+ * group gives a random permutation over the whole working set.
+ */
+static void **build_chase(char *buf, size_t lines, size_t group, rng_t *rng, size_t *order, size_t *gperm){
+
+  size_t ngroups = (lines + group - 1) / group;
+  size_t g, i, lo, n, k, tmp;
+  void **prev = NULL, **head = NULL, **cur;
+
+  for (i = 0; i < lines; i++) order[i] = i;
+  for (g = 0; g < ngroups; g++) gperm[g] = g;
+
+  /* Fisher-Yates within each group, then over the groups */
+  for (g = 0; g < ngroups; g++) {
+    lo = g * group;
+    n = (lines - lo < group) ? lines - lo : group;
+    for (i = n - 1; i > 0; i--) {
+      k = rng_below(rng, i + 1);
+      tmp = order[lo + i]; order[lo + i] = order[lo + k]; order[lo + k] = tmp;
+    }
+  }
+  for (g = ngroups - 1; g > 0; g--) {
+    k = rng_below(rng, g + 1);
+    tmp = gperm[g]; gperm[g] = gperm[k]; gperm[k] = tmp;
+  }
+
+  for (g = 0; g < ngroups; g++) {
+    lo = gperm[g] * group;
+    n = (lines - lo < group) ? lines - lo : group;
+    for (i = 0; i < n; i++) {
+      cur = (void **)(buf + order[lo + i] * CHASE_LINE);
+      if (prev) *prev = (void *)cur;
+      else head = cur;
+      prev = cur;
+    }
+  }
+  *prev = (void *)head;
+
+  return head;
+}
+
+/* allocate 'maxbytes' per thread and measure the latency of   */
+/* dependent loads by chasing a randomly permuted cyclic list, */
+/* for working sets from 4 KB up to 'maxbytes'. With page_aware */
+/* all lines of a page are visited before moving to the next.  */
+int mem_latency(size_t maxbytes, unsigned long reps, int page_aware){
+
+  size_t maxlines = maxbytes / CHASE_LINE;
+  size_t ws, nsizes = 0, k;
+  int t, failed = 0;
+  size_t sizes[128];
+  double lat[128];
+  unsigned long steps;
+  char title[96], buf[32];
+  void ** volatile sink = NULL;
+
+  sampler_t smp;
+
+  int nthreads;
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  if (maxlines < CHASE_PAGE_LINES) {
+    printf("The latency benchmark needs a size of at least 4 KB.\n");
+    return 0;
+  }
+
+  /* working sets: powers of two from 4 KB and the points half way between */
+  for (ws = 4096; ws <= maxbytes && nsizes < 126; ws *= 2) {
+    sizes[nsizes++] = ws;
+    if (ws + ws / 2 <= maxbytes) sizes[nsizes++] = ws + ws / 2;
+  }
+
+  /* one array of nbytes per thread, placed according to --numa */
+  int **arrays = numa_alloc_arrays(nthreads, maxbytes, 0, 0);
+  if (arrays == NULL) {
+    printf("Out Of Memory: could not allocate space for the array.\n");
+    return 0;
+  }
+
+  void ***heads = (void ***)malloc(nthreads * sizeof(void **));
+  size_t **orders = (size_t **)calloc(nthreads, sizeof(size_t *));
+  size_t **gperms = (size_t **)calloc(nthreads, sizeof(size_t *));
+  if (!heads || !orders || !gperms) {
+    printf("Out Of Memory: could not allocate space for the list.\n");
+    free(heads);
+    free(orders);
+    free(gperms);
+    numa_free_arrays(arrays, nthreads, maxbytes);
+    return 0;
+  }
+
+  for (k = 0; k < nsizes; k++) {
+
+    ws = sizes[k];
+
+    /* every thread builds the list in its own array */
+    # pragma omp parallel private(t)
+    {
+        size_t lines = ws / CHASE_LINE;
+        t = omp_get_thread_num();
+        if (!orders[t]) {
+          orders[t] = (size_t *)malloc(maxlines * sizeof(size_t));
+          gperms[t] = (size_t *)malloc(maxlines * sizeof(size_t));
+        }
+        if (orders[t] && gperms[t]) {
+          heads[t] = build_chase((char *)arrays[t], lines, page_aware ? CHASE_PAGE_LINES : lines,
+                                 rng_thread(), orders[t], gperms[t]);
+        }
+        else heads[t] = NULL;
+    }
+    for (t = 0; t < nthreads; t++) {
+      if (!heads[t]) failed = 1;
+    }
+    if (failed) {
+      printf("Out Of Memory: could not allocate space for the list.\n");
+      break;
+    }
+
+    sprintf(title, "Pointer chase%s, %s working set", page_aware ? " (page-aware)" : "", format_bytes(buf, ws));
+    steps = reps;
+    sampler_init(&smp, title);
+    if (steps == 0) sampler_calibrate(&smp, &steps);
+    while(sampler_next(&smp)){
+      # pragma omp parallel
+      {
+          void **p = heads[omp_get_thread_num()];
+          unsigned long i;
+          sampler_thread_start(&smp);
+          for(i = 0; i < steps; i++){
+              p = (void **)*p;
+          }
+          sampler_thread_stop(&smp);
+          /* keep the chase alive */
+          if (omp_get_thread_num() == 0) sink = p;
+      }
+    }
+    sampler_set_work(&smp, (double)steps * nthreads, (double)steps * CHASE_LINE * nthreads);
+    sampler_set_latency(&smp, (double)steps);
+    lat[k] = sampler_report(&smp) / steps;
+  }
+
+  if (!failed) {
+    printf("\nLoad latency%s per working set:\n", page_aware ? " (page-aware)" : "");
+    for (k = 0; k < nsizes; k++) {
+      printf("  %10s  %8.2f ns\n", format_bytes(buf, sizes[k]), lat[k] * 1e9);
+    }
+    printf("Keep result: %p\n\n", (void *)sink);
+  }
+
+  for (t = 0; t < nthreads; t++) {
+    free(orders[t]);
+    free(gperms[t]);
+  }
+  free(orders);
+  free(gperms);
+  free(heads);
+  numa_free_arrays(arrays, nthreads, maxbytes);
+
+  return 0;
+}
+
+
+/* load intensities of the loaded latency benchmark: nop delays per line, -1 for no load */
+#define LOADED_STEPS 13
+static int loaded_delay[LOADED_STEPS] = {-1, 4096, 2048, 1024, 512, 256, 128, 64, 32, 16, 8, 4, 0};
+
+/* the chasing thread tells the load threads to stop through this flag */
+static volatile int loaded_stop;
+
+/*
+ * Thread 0 chases a random cycle through its array of 'nbytes' while
+ * all other threads stream through their own arrays (reading, or
+ * writing with write set), waiting 'delay' nops after every cache line.
+ * Stepping the delay from no load to full speed gives the latency of
+ * the chase against the bandwidth drawn by the others.
+ */
+int mem_loaded_latency(size_t nbytes, unsigned long reps, int write){
+
+  size_t lines = nbytes / CHASE_LINE;
+  size_t nelements = nbytes / sizeof(double);
+  double lat[LOADED_STEPS], gbs[LOADED_STEPS], chase_s, runs;
+  unsigned long steps;
+  int k, t, recorded;
+  char title[96], buf[32];
+  void ** volatile sink = NULL;
+  double * volatile loaded_bytes;
+  double total = 0.0;
+
+  sampler_t smp;
+
+  int nthreads;
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  if (nthreads < 2) {
+    fprintf(stderr, "ERROR: the loaded latency benchmark needs at least two threads...\n");
+    return 0;
+  }
+  if (lines < CHASE_PAGE_LINES) {
+    printf("The loaded latency benchmark needs a size of at least 4 KB.\n");
+    return 0;
+  }
+
+  /* one array of nbytes per thread, placed according to --numa */
+  int **arrays = numa_alloc_arrays(nthreads, nbytes, 1, 0);
+  size_t *order = (size_t *)malloc(lines * sizeof(size_t));
+  size_t *gperm = (size_t *)malloc(lines * sizeof(size_t));
+  loaded_bytes = (double *)calloc(nthreads * 8, sizeof(double));
+  if (!arrays || !order || !gperm || !loaded_bytes) {
+    printf("Out Of Memory: could not allocate space for the arrays.\n");
+    numa_free_arrays(arrays, nthreads, nbytes);
+    free(order);
+    free(gperm);
+    free((double *)loaded_bytes);
+    return 0;
+  }
+
+  /* one random cycle over the whole array, so the chase goes to memory */
+  void **head = build_chase((char *)arrays[0], lines, lines, rng_thread(), order, gperm);
+
+  for (k = 0; k < LOADED_STEPS; k++) {
+
+    if (loaded_delay[k] < 0) sprintf(title, "Loaded latency, %s of %s, no load", format_bytes(buf, nbytes), write ? "write" : "read");
+    else sprintf(title, "Loaded latency, %s of %s, %s load with delay %d", format_bytes(buf, nbytes),
+                 write ? "write" : "read", write ? "write" : "read", loaded_delay[k]);
+    steps = reps;
+    chase_s = 0.0;
+    runs = 0.0;
+    memset((double *)loaded_bytes, 0, nthreads * 8 * sizeof(double));
+    sampler_init(&smp, title);
+    if (steps == 0) sampler_calibrate(&smp, &steps);
+    while(sampler_next(&smp)){
+      /* calibration runs are shorter, only recorded samples count towards the rates */
+      recorded = !smp.calibrating;
+      # pragma omp parallel private(t) reduction(+:total)
+      {
+          int delay = loaded_delay[k];
+          t = omp_get_thread_num();
+          if (t == 0) loaded_stop = 0;
+          sampler_thread_start(&smp);
+          if (t == 0) {
+              void **p = head;
+              unsigned long i;
+              unsigned long long t0 = timer_read();
+              for(i = 0; i < steps; i++){
+                  p = (void **)*p;
+              }
+              if (recorded) {
+                  chase_s += timer_seconds(timer_read() - t0);
+                  runs += 1.0;
+              }
+              loaded_stop = 1;
+              sink = p;
+          }
+          else if (delay >= 0) {
+              double *a = (double *)arrays[t], sum = 0.0;
+              size_t i = 0, bytes = 0;
+              int d, e;
+              while (!loaded_stop) {
+                  /* one line at a time, then the delay */
+                  if (write) for (e = 0; e < 8; e++) a[i + e] = (double)e;
+                  else for (e = 0; e < 8; e++) sum += a[i + e];
+                  for (d = 0; d < delay; d++) __asm__ __volatile__ ("nop");
+                  bytes += CHASE_LINE;
+                  i += 8;
+                  if (i + 8 > nelements) i = 0;
+              }
+              if (recorded) loaded_bytes[t * 8] += (double)bytes;
+              total += sum;
+          }
+          sampler_thread_stop(&smp);
+      }
+    }
+
+    /* the bytes of a record are the load traffic of an average sample */
+    gbs[k] = 0.0;
+    for (t = 1; t < nthreads; t++) gbs[k] += loaded_bytes[t * 8];
+    sampler_set_work(&smp, (double)steps, gbs[k] / runs);
+    sampler_set_latency(&smp, (double)steps);
+    lat[k] = sampler_report(&smp) / steps;
+    gbs[k] = gbs[k] / chase_s / 1e9;
+  }
+
+  printf("\nLatency of thread 0 against the %s bandwidth of %d other threads:\n", write ? "write" : "read", nthreads - 1);
+  printf("  %10s  %12s  %12s\n", "delay", "load GB/s", "latency ns");
+  for (k = 0; k < LOADED_STEPS; k++) {
+    if (loaded_delay[k] < 0) printf("  %10s", "no load");
+    else printf("  %10d", loaded_delay[k]);
+    printf("  %12.3f  %12.2f\n", gbs[k], lat[k] * 1e9);
+  }
+  printf("Keep result: %p %f\n\n", (void *)sink, total);
+
+  free(order);
+  free(gperm);
+  free((double *)loaded_bytes);
+  numa_free_arrays(arrays, nthreads, nbytes);
+
+  return 0;
+}
+
+
+/* base page size stepped over by the TLB sweep */
+#define TLB_PAGE 4096
+/* access patterns of the TLB sweep */
+#define TLB_PATTERNS 3
+
+static char *tlb_patterns[TLB_PATTERNS] = {"chase", "strided", "random"};
+
+/*
+ * Link one line of each of the first 'npages' base pages of buf into a
+ * random cycle and return its head. The line used within a page is
+ * drawn at random, so the lines spread over all cache sets rather than
+ * piling into one, also when huge pages make the physical addresses
+ * follow the page number, and the chase stays in the caches. On return
+ * 'order' holds the byte offsets of the lines in the order of the cycle
+ * and 'linear' the same offsets in page order.
+ */
+static void **build_page_chase(char *buf, size_t npages, rng_t *rng, size_t *order, size_t *linear){
+
+  size_t i, k, tmp;
+  void **prev = NULL, **head = NULL, **cur;
+
+  for (i = 0; i < npages; i++) order[i] = i;
+  for (i = npages - 1; i > 0; i--) {
+    k = rng_below(rng, i + 1);
+    tmp = order[i]; order[i] = order[k]; order[k] = tmp;
+  }
+
+  for (i = 0; i < npages; i++) {
+    k = order[i];
+    order[i] = k * TLB_PAGE + rng_below(rng, TLB_PAGE / CHASE_LINE) * CHASE_LINE;
+    linear[k] = order[i];
+    cur = (void **)(buf + order[i]);
+    if (prev) *prev = (void *)cur;
+    else head = cur;
+    prev = cur;
+  }
+  *prev = (void *)head;
+
+  return head;
+}
+
+/* touch one line per 4 KB page over a growing number of pages, once  */
+/* on base pages and once on the huge pages selected with --pages     */
+/* (thp if none were), to find the TLB reach and what huge pages buy. */
+/* Every size runs three patterns: a dependent chase through the      */
+/* pages in random order, and independent loads from the pages in     */
+/* address order (strided) and in random order.                       */
+int mem_tlb_sweep(size_t maxbytes, unsigned long reps){
+
+  size_t maxpages = maxbytes / TLB_PAGE;
+  size_t sizes[128], np, nsizes = 0, k;
+  double lat[TLB_PATTERNS][2][128];
+  int modes[2], saved_mode = pages_mode;
+  char *names[2], *saved_name = pages_name;
+  int m, t, pat, failed = 0;
+  unsigned long steps;
+  char title[128], buf[32];
+  void ** volatile sink = NULL;
+  volatile unsigned long keep = 0;
+
+  sampler_t smp;
+
+  int nthreads;
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  if (maxpages < 16) {
+    printf("The TLB sweep needs a size of at least 64 KB.\n");
+    return 0;
+  }
+
+  /* page counts: powers of two from 8 and the points half way between */
+  for (np = 8; np <= maxpages && nsizes < 126; np *= 2) {
+    sizes[nsizes++] = np;
+    if (np + np / 2 <= maxpages) sizes[nsizes++] = np + np / 2;
+  }
+
+  modes[0] = PAGES_4K;
+  names[0] = "4K";
+  if (saved_mode == PAGES_DEFAULT || saved_mode == PAGES_4K) {
+    modes[1] = PAGES_THP;
+    names[1] = "thp";
+  }
+  else {
+    modes[1] = saved_mode;
+    names[1] = saved_name;
+  }
+
+  size_t **orders = (size_t **)calloc(nthreads, sizeof(size_t *));
+  size_t **linears = (size_t **)calloc(nthreads, sizeof(size_t *));
+  void ***heads = (void ***)malloc(nthreads * sizeof(void **));
+  if (!orders || !linears || !heads) {
+    printf("Out Of Memory: could not allocate space for the list.\n");
+    free(orders);
+    free(linears);
+    free(heads);
+    return 0;
+  }
+
+  for (m = 0; m < 2 && !failed; m++) {
+
+    pages_mode = modes[m];
+    pages_name = names[m];
+
+    /* one array of maxbytes per thread with this page size, placed according to --numa */
+    int **arrays = numa_alloc_arrays(nthreads, maxbytes, 1, 0);
+    if (arrays == NULL) {
+      printf("Out Of Memory: could not allocate space for the array with %s pages.\n", names[m]);
+      failed = 1;
+      break;
+    }
+
+    for (k = 0; k < nsizes; k++) {
+
+      np = sizes[k];
+
+      # pragma omp parallel private(t)
+      {
+          t = omp_get_thread_num();
+          if (!orders[t]) orders[t] = (size_t *)malloc(maxpages * sizeof(size_t));
+          if (!linears[t]) linears[t] = (size_t *)malloc(maxpages * sizeof(size_t));
+          heads[t] = (orders[t] && linears[t]) ?
+            build_page_chase((char *)arrays[t], np, rng_thread(), orders[t], linears[t]) : NULL;
+      }
+      for (t = 0; t < nthreads; t++) {
+        if (!heads[t]) failed = 1;
+      }
+      if (failed) {
+        printf("Out Of Memory: could not allocate space for the list.\n");
+        break;
+      }
+
+      for (pat = 0; pat < TLB_PATTERNS; pat++) {
+
+        sprintf(title, "TLB sweep, %zu pages (%s span), %s pages, %s", np, format_bytes(buf, np * TLB_PAGE),
+                names[m], tlb_patterns[pat]);
+        steps = reps;
+        sampler_init(&smp, title);
+        if (steps == 0) sampler_calibrate(&smp, &steps);
+        while(sampler_next(&smp)){
+          # pragma omp parallel
+          {
+              int tid = omp_get_thread_num();
+              unsigned long i;
+              if (pat == 0) {
+                  void **p = heads[tid];
+                  sampler_thread_start(&smp);
+                  for(i = 0; i < steps; i++){
+                      p = (void **)*p;
+                  }
+                  sampler_thread_stop(&smp);
+                  if (tid == 0) sink = p;
+              }
+              else {
+                  char *base = (char *)arrays[tid];
+                  size_t *off = (pat == 1) ? linears[tid] : orders[tid];
+                  size_t j = 0;
+                  unsigned long sum = 0;
+                  sampler_thread_start(&smp);
+                  for(i = 0; i < steps; i++){
+                      sum ^= (unsigned long)*(void **)(base + off[j]);
+                      if (++j == np) j = 0;
+                  }
+                  sampler_thread_stop(&smp);
+                  if (tid == 0) keep = sum;
+              }
+          }
+        }
+        sampler_set_work(&smp, (double)steps * nthreads, (double)steps * CHASE_LINE * nthreads);
+        if (pat == 0) sampler_set_latency(&smp, (double)steps);
+        lat[pat][m][k] = sampler_report(&smp) / steps;
+      }
+    }
+
+    numa_free_arrays(arrays, nthreads, maxbytes);
+  }
+
+  pages_mode = saved_mode;
+  pages_name = saved_name;
+
+  if (!failed) {
+    printf("\nTime per load, one load per 4 KB page, on 4K and %s pages:\n", names[1]);
+    printf("  %10s  %10s", "", "");
+    for (pat = 0; pat < TLB_PATTERNS; pat++) printf("  %-26s", tlb_patterns[pat]);
+    printf("\n  %10s  %10s", "pages", "span");
+    for (pat = 0; pat < TLB_PATTERNS; pat++) printf("  %8s %8s %8s", "4K ns", names[1], "speedup");
+    printf("\n");
+    for (k = 0; k < nsizes; k++) {
+      printf("  %10zu  %10s", sizes[k], format_bytes(buf, sizes[k] * TLB_PAGE));
+      for (pat = 0; pat < TLB_PATTERNS; pat++)
+        printf("  %8.2f %8.2f %8.2f", lat[pat][0][k] * 1e9, lat[pat][1][k] * 1e9, lat[pat][0][k] / lat[pat][1][k]);
+      printf("\n");
+    }
+    printf("Keep result: %p %lu\n\n", (void *)sink, keep);
+  }
+
+  for (t = 0; t < nthreads; t++) {
+    free(orders[t]);
+    free(linears[t]);
+  }
+  free(orders);
+  free(linears);
+  free(heads);
+
+  return 0;
+}
+
+
+/* STREAM kernels over per-thread double arrays */
+#define STREAM_NKERNELS 6
+
+static char *stream_names[STREAM_NKERNELS] = {"copy", "scale", "add", "triad", "sum", "fill"};
+/* arrays read and written per element by each kernel */
+static int stream_reads[STREAM_NKERNELS]  = {1, 1, 2, 2, 1, 0};
+static int stream_writes[STREAM_NKERNELS] = {1, 1, 1, 1, 0, 1};
+
+static double stream_kernel(int k, double *a, double *b, double *c, double q, size_t n){
+
+  size_t i;
+  double sum = 0.0;
+
+  switch (k) {
+  case 0:
+    for (i = 0; i < n; i++) c[i] = a[i];
+    break;
+  case 1:
+    for (i = 0; i < n; i++) b[i] = q * c[i];
+    break;
+  case 2:
+    for (i = 0; i < n; i++) c[i] = a[i] + b[i];
+    break;
+  case 3:
+    for (i = 0; i < n; i++) a[i] = b[i] + q * c[i];
+    break;
+  case 4:
+    /* four partial sums, so the loop is not bound by the latency of one add chain */
+    {
+      double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+      for (i = 0; i + 3 < n; i += 4) {
+        s0 += a[i];
+        s1 += a[i+1];
+        s2 += a[i+2];
+        s3 += a[i+3];
+      }
+      for (; i < n; i++) s0 += a[i];
+      sum = (s0 + s1) + (s2 + s3);
+    }
+    break;
+  default:
+    for (i = 0; i < n; i++) a[i] = q;
+    break;
+  }
+
+  return sum;
+}
+
+/* allocate three arrays of 'nbytes' of doubles per thread,  */
+/* first touched by their thread, and run the STREAM kernels  */
+/* (or just the one named by 'kernel') over them.            */
+int mem_stream(size_t nbytes, char *kernel){
+
+  size_t nelements = nbytes / sizeof(double);
+  double q = 3.0, bytes, total = 0.0;
+  double rate[STREAM_NKERNELS];
+  unsigned long reps;
+  char title[64];
+  int k, run = 0;
+
+  sampler_t smp;
+
+  int nthreads;
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  /* one set of arrays of nbytes per thread, placed according to --numa */
+  double **a = (double **)numa_alloc_arrays(nthreads, nbytes, 0, 0);
+  double **b = (double **)numa_alloc_arrays(nthreads, nbytes, 0, 0);
+  double **c = (double **)numa_alloc_arrays(nthreads, nbytes, 0, 0);
+  if (!a || !b || !c) {
+    printf("Out Of Memory: could not allocate space for the arrays.\n");
+    return 0;
+  }
+
+  /* initialise in the owning thread, so the pages are first touched there */
+  # pragma omp parallel
   {
-      int nl;
-      for(i=0; i<nelements; i++){
-	  nl = rand() % (nelements);
+      int t = omp_get_thread_num();
+      size_t i;
+      for (i = 0; i < nelements; i++) {
+          a[t][i] = 1.0;
+          b[t][i] = 2.0;
+          c[t][i] = 0.0;
       }
-      n = nl;
   }
 
-  clock_gettime(CLOCK, &end);
-  oh = elapsed_time_hr(start, end, "Read random");
-  
-  printf("Make sure the result is kept: %d\n", n);
+  for (k = 0; k < STREAM_NKERNELS; k++) {
+
+    rate[k] = 0.0;
+    if (strcmp(kernel, "all") != 0 && strcmp(kernel, stream_names[k]) != 0) continue;
+    run++;
+
+    sprintf(title, "STREAM %s", stream_names[k]);
+    reps = 0;
+    sampler_init(&smp, title);
+    sampler_calibrate(&smp, &reps);
+    while(sampler_next(&smp)){
+      # pragma omp parallel reduction(+:total)
+      {
+          int t = omp_get_thread_num();
+          unsigned long j;
+          sampler_thread_start(&smp);
+          for (j = 0; j < reps; j++) {
+              total += stream_kernel(k, a[t], b[t], c[t], q, nelements);
+          }
+          sampler_thread_stop(&smp);
+      }
+    }
 
-  srand(t);
+    /* every element written is also read first to allocate its line */
+    bytes = (double)nelements * sizeof(double) * (stream_reads[k] + 2 * stream_writes[k]);
+    sampler_set_work(&smp, (double)reps * nelements * nthreads, (double)reps * bytes * nthreads);
+    rate[k] = (double)reps * nthreads * nelements * sizeof(double) * (stream_reads[k] + stream_writes[k])
+      / sampler_report(&smp) / 1e9;
+  }
 
-  /* measure the random reads */
-  clock_gettime(CLOCK, &start);
+  if (run == 0) {
+    fprintf(stderr, "ERROR: unknown STREAM kernel %s...\n", kernel);
+  }
+  else {
+    printf("\nSTREAM bandwidth without write-allocate traffic, as STREAM itself reports it:\n");
+    for (k = 0; k < STREAM_NKERNELS; k++) {
+      if (rate[k] > 0.0) printf("  %-6s %12.3f GB/s\n", stream_names[k], rate[k]);
+    }
+    printf("Keep result: %f %f\n\n", total, a[0][nelements / 2]);
+  }
+
+  numa_free_arrays((int **)a, nthreads, nbytes);
+  numa_free_arrays((int **)b, nthreads, nbytes);
+  numa_free_arrays((int **)c, nthreads, nbytes);
+
+  return 0;
+}
+
+
+/* explicit vector kernels over per-thread double arrays */
+#define VECTOR_NKERNELS 3
+
+static char *vector_names[VECTOR_NKERNELS] = {"read", "write", "copy"};
+static int vector_reads[VECTOR_NKERNELS]  = {1, 0, 1};
+static int vector_writes[VECTOR_NKERNELS] = {0, 1, 1};
+
+/* run the read, write and copy kernels (or just the one named by */
+/* 'kernel') over two arrays of 'nbytes' of doubles per thread,  */
+/* once with every vector width selected by --vector-width.      */
+int mem_vector(size_t nbytes, char *kernel){
+
+  size_t nelements = nbytes / sizeof(double);
+  double bytes, total = 0.0;
+  double rate[VECTOR_NKERNELS][4];
+  int widths[4];
+  int nwidths, k, w, run = 0;
+  unsigned long reps;
+  char title[96];
+
+  sampler_t smp;
+
+  int nthreads;
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  for (k = 0; k < VECTOR_NKERNELS; k++) {
+    if (strcmp(kernel, "all") == 0 || strcmp(kernel, vector_names[k]) == 0) run++;
+  }
+  if (run == 0) {
+    fprintf(stderr, "ERROR: unknown vector kernel %s...\n", kernel);
+    return 0;
+  }
+
+  nwidths = simd_widths(widths);
+
+  /* one pair of arrays of nbytes per thread, placed according to --numa */
+  double **a = (double **)numa_alloc_arrays(nthreads, nbytes, 0, 0);
+  double **b = (double **)numa_alloc_arrays(nthreads, nbytes, 0, 0);
+  if (!a || !b) {
+    printf("Out Of Memory: could not allocate space for the arrays.\n");
+    return 0;
+  }
 
-  # pragma omp parallel private(i, receive)
+  /* initialise in the owning thread, so the pages are first touched there */
+  # pragma omp parallel
   {
-      int receivel;
-      int nl;
-      int *array = arrays[omp_get_thread_num()];
-      for(i = 0; i < nelements; i++){
-	  nl = rand() % (nelements);
-	  receivel = array[nl];
+      int t = omp_get_thread_num();
+      size_t i;
+      for (i = 0; i < nelements; i++) {
+          a[t][i] = 1.0;
+          b[t][i] = 2.0;
       }
-      receive = receivel;
   }
-  
-  clock_gettime(CLOCK, &end);
-  rt = elapsed_time_hr(start, end, "Read random");
-  
-  printf("Make sure the result is kept: %d\n", receive);
 
-  printf("Runtime: %f\n", (rt-oh));
+  for (k = 0; k < VECTOR_NKERNELS; k++) {
+
+    for (w = 0; w < nwidths; w++) rate[k][w] = 0.0;
+    if (strcmp(kernel, "all") != 0 && strcmp(kernel, vector_names[k]) != 0) continue;
+
+    for (w = 0; w < nwidths; w++) {
+
+      sprintf(title, "Vector %s, %s", vector_names[k], simd_name(widths[w]));
+      reps = 0;
+      sampler_init(&smp, title);
+      sampler_calibrate(&smp, &reps);
+      while(sampler_next(&smp)){
+        # pragma omp parallel reduction(+:total)
+        {
+            int t = omp_get_thread_num();
+            unsigned long j;
+            sampler_thread_start(&smp);
+            for (j = 0; j < reps; j++) {
+                if (k == 0) total += simd_read(widths[w], a[t], nelements);
+                else if (k == 1) simd_write(widths[w], a[t], nelements, (double)j);
+                else simd_copy(widths[w], b[t], a[t], nelements);
+            }
+            sampler_thread_stop(&smp);
+        }
+      }
 
-  printf("Finished reading %d MB of memory (%d ints) in a random manner.\n\n", size, nelements);
-  
-  for (i = 0; i < nthreads; i++) {
-      free(arrays[i]);
+      /* as for STREAM, every line written is also read to allocate it */
+      bytes = (double)nelements * sizeof(double) * (vector_reads[k] + 2 * vector_writes[k]);
+      sampler_set_work(&smp, (double)reps * nelements * nthreads, (double)reps * bytes * nthreads);
+      rate[k][w] = (double)reps * nthreads * nelements * sizeof(double) * (vector_reads[k] + vector_writes[k])
+        / sampler_report(&smp) / 1e9;
+    }
+  }
+
+  printf("\nVector kernel bandwidth without write-allocate traffic (GB/s, all threads):\n");
+  printf("  %-16s", "");
+  for (k = 0; k < VECTOR_NKERNELS; k++) printf("  %10s", vector_names[k]);
+  printf("\n");
+  for (w = 0; w < nwidths; w++) {
+    printf("  %-16s", simd_name(widths[w]));
+    for (k = 0; k < VECTOR_NKERNELS; k++) {
+      if (rate[k][w] > 0.0) printf("  %10.3f", rate[k][w]);
+      else printf("  %10s", "-");
+    }
+    printf("\n");
   }
-  free(arrays); // Remember to free !
+  printf("Keep result: %f %f\n\n", total, b[0][nelements / 2]);
+
+  numa_free_arrays((int **)a, nthreads, nbytes);
+  numa_free_arrays((int **)b, nthreads, nbytes);
+
+  return 0;
+}
+
+
+/* data and unified caches of cpu0, as listed in /sys */
+#define MAX_CACHES 8
+
+typedef struct {
+  int level;
+  char type[16];
+  size_t size;
+  int shared;       /* number of CPUs sharing the cache */
+} sys_cache_t;
+
+static int sys_caches(sys_cache_t *caches){
+
+  char path[128], line[256], *p;
+  FILE *f;
+  int i, n = 0, lo, hi;
+  unsigned long kb;
+
+  for (i = 0; i < 16 && n < MAX_CACHES; i++) {
+    sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/type", i);
+    if (!(f = fopen(path, "r"))) break;
+    if (fscanf(f, "%15s", caches[n].type) != 1) caches[n].type[0] = '\0';
+    fclose(f);
+    if (strcmp(caches[n].type, "Instruction") == 0) continue;
+
+    sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/level", i);
+    if (!(f = fopen(path, "r"))) continue;
+    if (fscanf(f, "%d", &caches[n].level) != 1) caches[n].level = 0;
+    fclose(f);
+
+    sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/size", i);
+    if (!(f = fopen(path, "r"))) continue;
+    if (fscanf(f, "%luK", &kb) != 1) kb = 0;
+    fclose(f);
+    caches[n].size = (size_t)kb * 1024;
+
+    /* count the CPUs in a list such as 0-3,8-11 */
+    caches[n].shared = 1;
+    sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/shared_cpu_list", i);
+    if ((f = fopen(path, "r"))) {
+      if (fgets(line, sizeof(line), f)) {
+        caches[n].shared = 0;
+        for (p = strtok(line, ",\n"); p; p = strtok(NULL, ",\n")) {
+          if (sscanf(p, "%d-%d", &lo, &hi) == 2) caches[n].shared += hi - lo + 1;
+          else caches[n].shared++;
+        }
+      }
+      fclose(f);
+    }
+    n++;
+  }
+
+  return n;
+}
+
+/*
+ * Report the knees of a bandwidth curve: a knee is placed after the
+ * last working set whose bandwidth was within 25% of the best seen since
+ * the previous knee, once the next two working sets fall below that.
+ */
+static void report_knees(char *name, size_t *sizes, double *bw, int n, int nthreads,
+                         sys_cache_t *caches, int ncaches){
+
+  double level = bw[0];
+  int i, c, best, found = 0;
+  size_t fit, share;
+  double d, bestd;
+  char buf[32], cbuf[32];
+
+  printf("\nKnees in the %s bandwidth:\n", name);
+  for (i = 1; i < n; i++) {
+    /* the drop has to hold for the next working set too, to skip single noisy points */
+    if (bw[i] < 0.75 * level && (i + 1 == n || bw[i+1] < 0.75 * level)) {
+      fit = sizes[i-1] * nthreads;
+      printf("  after %s per thread (%s in total): %.3f -> %.3f GB/s", format_bytes(buf, sizes[i-1]),
+             format_bytes(cbuf, fit), level, bw[i]);
+
+      /* closest cache on a log scale, by the share of it each thread gets */
+      best = -1;
+      bestd = 0.0;
+      for (c = 0; c < ncaches; c++) {
+        share = caches[c].size / (caches[c].shared < nthreads ? caches[c].shared : nthreads);
+        d = fabs(log((double)share / (double)sizes[i-1]));
+        if (best < 0 || d < bestd) { best = c; bestd = d; }
+      }
+      if (best >= 0) printf("   closest: L%d %s", caches[best].level, format_bytes(cbuf, caches[best].size));
+      printf("\n");
+      level = bw[i];
+      found++;
+    }
+    else if (bw[i] > level) level = bw[i];
+  }
+  if (!found) printf("  none found\n");
+}
+
+/* sweep contiguous read and write bandwidth over working sets  */
+/* from 1 KB up to 'maxbytes' per thread and infer the cache   */
+/* sizes from the knees of the curves, compared with /sys.      */
+int mem_cache_sweep(size_t maxbytes){
+
+  size_t sizes[128], ws, n;
+  double rbw[128], wbw[128], total = 0.0, q = 1.0;
+  int nsizes = 0, k, kernel, ncaches, c;
+  unsigned long reps;
+  char title[96], buf[32];
+  sys_cache_t caches[MAX_CACHES];
+
+  sampler_t smp;
+
+  int nthreads;
+  # pragma omp parallel
+  if (omp_get_thread_num() == 0) nthreads = omp_get_num_threads();
+
+  /* working sets: powers of two from 1 KB and the points half way between */
+  for (ws = 1024; ws <= maxbytes && nsizes < 126; ws *= 2) {
+    sizes[nsizes++] = ws;
+    if (ws + ws / 2 <= maxbytes) sizes[nsizes++] = ws + ws / 2;
+  }
+  if (nsizes < 2) {
+    printf("The cache sweep needs a size of at least 2 KB.\n");
+    return 0;
+  }
+
+  /* one array of nbytes per thread, placed according to --numa */
+  double **a = (double **)numa_alloc_arrays(nthreads, maxbytes, 0, 0);
+  if (!a) {
+    printf("Out Of Memory: could not allocate space for the array.\n");
+    return 0;
+  }
+
+  # pragma omp parallel
+  {
+      int t = omp_get_thread_num();
+      size_t i;
+      for (i = 0; i < maxbytes / sizeof(double); i++) a[t][i] = 1.0;
+  }
+
+  /* kernel 4 is the STREAM sum (read), kernel 5 the fill (write) */
+  for (kernel = 4; kernel <= 5; kernel++) {
+    for (k = 0; k < nsizes; k++) {
+
+      n = sizes[k] / sizeof(double);
+      sprintf(title, "Cache sweep %s, %s working set", kernel == 4 ? "read" : "write", format_bytes(buf, sizes[k]));
+      reps = 0;
+      sampler_init(&smp, title);
+      sampler_calibrate(&smp, &reps);
+      while(sampler_next(&smp)){
+        # pragma omp parallel reduction(+:total)
+        {
+            int t = omp_get_thread_num();
+            unsigned long j;
+            sampler_thread_start(&smp);
+            for (j = 0; j < reps; j++) {
+                total += stream_kernel(kernel, a[t], NULL, NULL, q, n);
+            }
+            sampler_thread_stop(&smp);
+        }
+      }
+      sampler_set_work(&smp, (double)reps * n * nthreads, (double)reps * sizes[k] * nthreads);
+      if (kernel == 4) rbw[k] = (double)reps * sizes[k] * nthreads / sampler_report(&smp) / 1e9;
+      else wbw[k] = (double)reps * sizes[k] * nthreads / sampler_report(&smp) / 1e9;
+    }
+  }
+
+  printf("\nCache sweep bandwidth (GB/s, all threads):\n");
+  printf("  %10s  %12s  %12s\n", "per thread", "read", "write");
+  for (k = 0; k < nsizes; k++) {
+    printf("  %10s  %12.3f  %12.3f\n", format_bytes(buf, sizes[k]), rbw[k], wbw[k]);
+  }
+
+  ncaches = sys_caches(caches);
+  printf("\nCaches reported by /sys/devices/system/cpu/cpu0/cache:\n");
+  for (c = 0; c < ncaches; c++) {
+    printf("  L%d %-8s %10s  shared by %d CPUs\n", caches[c].level, caches[c].type,
+           format_bytes(buf, caches[c].size), caches[c].shared);
+  }
+  if (ncaches == 0) printf("  not available\n");
+
+  report_knees("read", sizes, rbw, nsizes, nthreads, caches, ncaches);
+  report_knees("write", sizes, wbw, nsizes, nthreads, caches, ncaches);
+  printf("Keep result: %f\n\n", total);
+
+  numa_free_arrays((int **)a, nthreads, maxbytes);
 
   return 0;
-  
 }
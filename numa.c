@@ -0,0 +1,333 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
+#include "numa.h"
+#include "pages.h"
+
+int numa_mode = NUMA_OFF;
+char *numa_name = "off";
+
+/* node holding each thread's array, -1 if unknown or interleaved; */
+/* one map per live allocation, kept in the order of allocation    */
+typedef struct numa_map {
+  int **arrays;
+  int n;
+  int *node;
+  struct numa_map *next;
+} numa_map_t;
+
+static numa_map_t *maps = NULL;
+
+#define NUMA_MAX_NODES 1024
+
+static int nnodes = 0;
+static int nonline = 0;
+static char online[NUMA_MAX_NODES];
+static int fixed_node = -1;
+
+int numa_select(char *m){
+
+  char *end;
+
+  if (strcmp(m, "off") == 0) numa_mode = NUMA_OFF;
+  else if (strcmp(m, "first-touch") == 0) numa_mode = NUMA_FIRST_TOUCH;
+  else if (strcmp(m, "local") == 0) numa_mode = NUMA_LOCAL;
+  else if (strcmp(m, "remote") == 0) numa_mode = NUMA_REMOTE;
+  else if (strcmp(m, "interleave") == 0) numa_mode = NUMA_INTERLEAVE;
+  else {
+    fixed_node = (int)strtol(m, &end, 10);
+    if (*m == '\0' || *end != '\0' || fixed_node < 0 || fixed_node >= NUMA_MAX_NODES) {
+      fprintf(stderr, "ERROR: unknown NUMA mode %s, use off, first-touch, local, remote, interleave or a node number\n", m);
+      return 1;
+    }
+    numa_mode = NUMA_NODE;
+  }
+
+#ifndef __linux__
+  if (numa_mode != NUMA_OFF && numa_mode != NUMA_FIRST_TOUCH) {
+    fprintf(stderr, "ERROR: NUMA memory policies are only supported on Linux\n");
+    return 1;
+  }
+#endif
+
+  numa_name = m;
+  return 0;
+}
+
+/* nodes listed as online, which need not be numbered contiguously */
+static void read_online(){
+
+  FILE *f;
+  char buf[256], *p, *dash;
+  int lo, hi, v;
+
+  if (nnodes) return;
+
+  f = fopen("/sys/devices/system/node/online", "r");
+  if (f) {
+    if (fgets(buf, sizeof(buf), f)) {
+      for (p = strtok(buf, ",\n"); p; p = strtok(NULL, ",\n")) {
+        lo = hi = atoi(p);
+        dash = strchr(p, '-');
+        if (dash) hi = atoi(dash + 1);
+        for (v = lo; v <= hi && v < NUMA_MAX_NODES; v++) {
+          if (!online[v]) nonline++;
+          online[v] = 1;
+          if (v + 1 > nnodes) nnodes = v + 1;
+        }
+      }
+    }
+    fclose(f);
+  }
+
+  /* without the list assume a single node 0 */
+  if (nnodes == 0) {
+    nnodes = 1;
+    nonline = 1;
+    online[0] = 1;
+  }
+}
+
+/* number of nodes, from the highest node listed as online */
+int numa_nodes(){
+
+  read_online();
+  return nnodes;
+}
+
+/* number of nodes actually online */
+static int online_nodes(){
+
+  read_online();
+  return nonline;
+}
+
+#ifdef __linux__
+
+/* node of the CPU the calling thread runs on */
+static int current_node(){
+
+  unsigned int cpu, node;
+
+  if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) return 0;
+  return (int)node;
+}
+
+/* node backing the page at p, after it has been touched */
+static int page_node(void *p){
+
+  int node = -1;
+
+  if (syscall(SYS_get_mempolicy, &node, NULL, 0, p, MPOL_F_NODE | MPOL_F_ADDR) != 0) return -1;
+  return node;
+}
+
+/* the next online node after 'node', wrapping around */
+static int next_online(int node){
+
+  int i;
+
+  for (i = 1; i <= numa_nodes(); i++) {
+    if (online[(node + i) % nnodes]) return (node + i) % nnodes;
+  }
+  return node;
+}
+
+/* apply the selected policy to a fresh mapping, before it is touched */
+static int place_memory(void *p, size_t n, int node){
+
+  unsigned long mask[NUMA_MAX_NODES / (8 * sizeof(unsigned long))];
+  int policy = MPOL_BIND, i;
+
+  memset(mask, 0, sizeof(mask));
+
+  switch (numa_mode) {
+  case NUMA_LOCAL:
+    break;
+  case NUMA_REMOTE:
+    node = next_online(node);
+    break;
+  case NUMA_NODE:
+    node = fixed_node;
+    break;
+  case NUMA_INTERLEAVE:
+    policy = MPOL_INTERLEAVE;
+    for (i = 0; i < numa_nodes(); i++) if (online[i]) mask[i / (8 * sizeof(unsigned long))] |= 1UL << (i % (8 * sizeof(unsigned long)));
+    break;
+  default:
+    return 0;
+  }
+  if (policy == MPOL_BIND) mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+
+  return syscall(SYS_mbind, p, n, policy, mask, NUMA_MAX_NODES, 0) != 0;
+}
+
+#else
+
+static int current_node(){ return 0; }
+static int page_node(void *p){ return 0; }
+static int place_memory(void *p, size_t n, int node){ return 0; }
+
+#endif
+
+/*
+ * Allocate one array of nbytes per thread. With --numa off this is done
+ * by the calling thread and the arrays are filled with data serially if
+ * fill is set; otherwise every thread of the team maps its own array,
+ * applies the memory policy and writes data to every element so the
+ * pages are first touched by their owner. Unless --pages is left at its
+ * default the arrays are mapped with the selected page size.
+ */
+int **numa_alloc_arrays(int nthreads, size_t nbytes, int fill, int data){
+
+  int **arrays = (int **)calloc(nthreads, sizeof(int *));
+  size_t i, nelements = nbytes / sizeof(int);
+  int j, failed = 0, unplaced = 0;
+  numa_map_t *map, **last;
+
+  if (!arrays) return NULL;
+
+  if (numa_mode == NUMA_OFF) {
+    for (j = 0; j < nthreads; j++) {
+      if (pages_mode == PAGES_DEFAULT) arrays[j] = (int *)malloc(nbytes);
+      else arrays[j] = (int *)pages_map(nbytes);
+      if (!arrays[j]) {
+        numa_free_arrays(arrays, j, nbytes);
+        return NULL;
+      }
+    }
+    if (fill) {
+      for (j = 0; j < nthreads; j++) {
+        for (i = 0; i < nelements; i++) arrays[j][i] = data;
+      }
+      pages_check(arrays[0], nbytes);
+    }
+    return arrays;
+  }
+
+  map = (numa_map_t *)malloc(sizeof(numa_map_t));
+  if (map) map->node = (int *)malloc(nthreads * sizeof(int));
+  if (!map || !map->node) {
+    free(map);
+    free(arrays);
+    return NULL;
+  }
+  map->arrays = arrays;
+  map->n = nthreads;
+  map->next = NULL;
+
+  if (numa_mode == NUMA_REMOTE && online_nodes() == 1) {
+    printf("Warning: only one NUMA node, remote memory is local.\n");
+  }
+
+# pragma omp parallel private(i, j) reduction(+:failed, unplaced)
+  {
+    int *a;
+
+    j = omp_get_thread_num();
+    a = (int *)pages_map(nbytes);
+    if (!a) failed++;
+    else {
+      if (place_memory(a, nbytes, current_node())) unplaced++;
+
+      /* first touch by the owning thread */
+      for (i = 0; i < nelements; i++) a[i] = data;
+
+      map->node[j] = (numa_mode == NUMA_INTERLEAVE) ? -1 : page_node(a);
+    }
+    arrays[j] = a;
+  }
+
+  if (unplaced) {
+    fprintf(stderr, "ERROR: mbind failed for %d arrays, they are placed by first touch only\n", unplaced);
+  }
+  if (failed) {
+    free(map->node);
+    free(map);
+    numa_free_arrays(arrays, nthreads, nbytes);
+    return NULL;
+  }
+  pages_check(arrays[0], nbytes);
+
+  for (last = &maps; *last; last = &(*last)->next) ;
+  *last = map;
+
+  return arrays;
+}
+
+void numa_free_arrays(int **arrays, int nthreads, size_t nbytes){
+
+  numa_map_t *map, **prev;
+  int j;
+
+  if (!arrays) return;
+
+  /* drop the node map of this allocation only */
+  for (prev = &maps; (map = *prev) != NULL; prev = &map->next) {
+    if (map->arrays == arrays) {
+      *prev = map->next;
+      free(map->node);
+      free(map);
+      break;
+    }
+  }
+
+  for (j = 0; j < nthreads; j++) {
+    if (!arrays[j]) continue;
+    if (numa_mode == NUMA_OFF && pages_mode == PAGES_DEFAULT) free(arrays[j]);
+    else pages_unmap(arrays[j], nbytes);
+  }
+  free(arrays);
+}
+
+/* node of the array of thread t in a live allocation, -1 if unknown */
+int numa_array_node(int **arrays, int t){
+
+  numa_map_t *map;
+
+  for (map = maps; map; map = map->next) {
+    if (map->arrays == arrays) return (t < map->n) ? map->node[t] : -1;
+  }
+
+  return -1;
+}
+
+/*
+ * Node of the array of thread t for the per-node bandwidth of a region.
+ * Benchmarks with several array sets allocate their main data first
+ * (STREAM a, the gather data before its indices), so the oldest live
+ * allocation is the one reported.
+ */
+int numa_thread_node(int t){
+  if (!maps || t >= maps->n) return -1;
+  return maps->node[t];
+}
@@ -0,0 +1,57 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <stddef.h>
+
+/*
+ * NUMA placement of the per-thread arrays of the memory benchmarks,
+ * selected with --numa:
+ *   off          arrays are allocated (and filled) by the master thread
+ *   first-touch  every thread allocates and first touches its own array
+ *   local        as first-touch, and mbind the array to the thread's node
+ *   remote       mbind the array to the next node round from the thread's
+ *   interleave   interleave the array's pages over all nodes
+ *   N            mbind every array to node N
+ * In all modes except off the node holding each thread's array is
+ * recorded for every allocation, so the results can give bandwidth per
+ * memory node.
+ */
+
+#define NUMA_OFF         0
+#define NUMA_FIRST_TOUCH 1
+#define NUMA_LOCAL       2
+#define NUMA_REMOTE      3
+#define NUMA_INTERLEAVE  4
+#define NUMA_NODE        5
+
+extern int numa_mode;
+extern char *numa_name;
+
+int numa_select(char *);
+int numa_nodes();
+int **numa_alloc_arrays(int, size_t, int, int);
+void numa_free_arrays(int **, int, size_t);
+int numa_array_node(int **, int);
+int numa_thread_node(int);
+
+#endif
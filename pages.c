@@ -0,0 +1,172 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "utils.h"
+#include "pages.h"
+
+/* older C libraries lack the page size encodings of MAP_HUGETLB */
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+#define HUGE_2M (2UL * 1048576)
+#define HUGE_1G (1024UL * 1048576)
+
+int pages_mode = PAGES_DEFAULT;
+char *pages_name = "default";
+
+int pages_select(char *m){
+
+  if (strcmp(m, "default") == 0) pages_mode = PAGES_DEFAULT;
+  else if (strcmp(m, "4K") == 0 || strcmp(m, "4k") == 0) pages_mode = PAGES_4K;
+  else if (strcmp(m, "thp") == 0) pages_mode = PAGES_THP;
+  else if (strcmp(m, "2M") == 0 || strcmp(m, "2m") == 0) pages_mode = PAGES_2M;
+  else if (strcmp(m, "1G") == 0 || strcmp(m, "1g") == 0) pages_mode = PAGES_1G;
+  else {
+    fprintf(stderr, "ERROR: unknown page size %s, use default, 4K, thp, 2M or 1G\n", m);
+    return 1;
+  }
+
+#ifndef __linux__
+  if (pages_mode != PAGES_DEFAULT) {
+    fprintf(stderr, "ERROR: page sizes can only be selected on Linux\n");
+    return 1;
+  }
+#endif
+
+  pages_name = m;
+  return 0;
+}
+
+/* bytes per page of the selected mode */
+size_t pages_size(){
+
+  switch (pages_mode) {
+  case PAGES_THP:
+  case PAGES_2M:
+    return HUGE_2M;
+  case PAGES_1G:
+    return HUGE_1G;
+  }
+
+#ifdef __linux__
+  return (size_t)sysconf(_SC_PAGESIZE);
+#else
+  return 4096;
+#endif
+}
+
+/* mappings are whole pages, so round n up */
+static size_t map_length(size_t n){
+  size_t ps = pages_size();
+  return (n + ps - 1) / ps * ps;
+}
+
+#ifdef __linux__
+
+/* map n bytes with the selected page size, NULL on failure */
+void *pages_map(size_t n){
+
+  size_t len = map_length(n);
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  char *p, *a;
+
+  if (pages_mode == PAGES_2M) flags |= MAP_HUGETLB | MAP_HUGE_2MB;
+  if (pages_mode == PAGES_1G) flags |= MAP_HUGETLB | MAP_HUGE_1GB;
+
+  if (pages_mode != PAGES_THP) {
+    p = (char *)mmap(NULL, len, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (p == MAP_FAILED) {
+      if (flags & MAP_HUGETLB) {
+        fprintf(stderr, "ERROR: not enough %s huge pages, reserve them under /sys/kernel/mm/hugepages\n", pages_name);
+      }
+      return NULL;
+    }
+    if (pages_mode == PAGES_4K) madvise(p, len, MADV_NOHUGEPAGE);
+    return p;
+  }
+
+  /* huge pages can only back 2 MB aligned ranges, so map a spare 2 MB and trim */
+  p = (char *)mmap(NULL, len + HUGE_2M, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (p == MAP_FAILED) return NULL;
+  a = (char *)(((unsigned long)p + HUGE_2M - 1) & ~(HUGE_2M - 1));
+  if (a > p) munmap(p, a - p);
+  if (a + len < p + len + HUGE_2M) munmap(a + len, p + len + HUGE_2M - (a + len));
+  madvise(a, len, MADV_HUGEPAGE);
+
+  return a;
+}
+
+void pages_unmap(void *p, size_t n){
+  munmap(p, map_length(n));
+}
+
+/* with thp, report how much of the touched mapping at p huge pages back */
+void pages_check(void *p, size_t n){
+
+  FILE *f;
+  char line[256], buf[32];
+  unsigned long start, end, kb;
+  int found = 0;
+
+  if (pages_mode != PAGES_THP) return;
+
+  f = fopen("/proc/self/smaps", "r");
+  if (!f) return;
+  while (fgets(line, sizeof(line), f)) {
+    /* mapping lines start with the address range, field lines with a name */
+    if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+      found = (unsigned long)p >= start && (unsigned long)p < end;
+    }
+    else if (found && sscanf(line, "AnonHugePages: %lu kB", &kb) == 1) {
+      printf("Transparent huge pages back %s", format_bytes(buf, (size_t)kb * 1024));
+      printf(" of the %s array of thread 0.\n", format_bytes(buf, n));
+      if ((size_t)kb * 1024 < n / 2) {
+        printf("Warning: check /sys/kernel/mm/transparent_hugepage/enabled, most of the array is on base pages.\n");
+      }
+      break;
+    }
+  }
+  fclose(f);
+}
+
+#else
+
+void *pages_map(size_t n){ return malloc(n); }
+void pages_unmap(void *p, size_t n){ free(p); }
+void pages_check(void *p, size_t n){ }
+
+#endif
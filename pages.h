@@ -0,0 +1,51 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#ifndef PAGES_H
+#define PAGES_H
+
+#include <stddef.h>
+
+/*
+ * Page size of the arrays of the memory benchmarks, selected with --pages:
+ *   default  malloc/mmap as usual, transparent huge pages as the system sets them
+ *   4K       base pages only, transparent huge pages disabled with madvise
+ *   thp      transparent huge pages requested with madvise(MADV_HUGEPAGE)
+ *   2M, 1G   explicit huge pages from the hugetlbfs pool with MAP_HUGETLB
+ * The hugetlbfs pool has to be reserved beforehand, e.g. through
+ * /proc/sys/vm/nr_hugepages, or the allocation fails.
+ */
+
+#define PAGES_DEFAULT 0
+#define PAGES_4K      1
+#define PAGES_THP     2
+#define PAGES_2M      3
+#define PAGES_1G      4
+
+extern int pages_mode;
+extern char *pages_name;
+
+int pages_select(char *);
+size_t pages_size();
+void *pages_map(size_t);
+void pages_unmap(void *, size_t);
+void pages_check(void *, size_t);
+
+#endif
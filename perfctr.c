@@ -0,0 +1,221 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <omp.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "perfctr.h"
+
+int perf_enabled = 0;
+
+char *perf_event_names[PERF_NEVENTS] = {
+  "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses", "dtlb_misses"
+};
+
+#ifdef __linux__
+
+#define PERF_NGROUPS 2
+#define PERF_GROUP_SIZE 3
+
+/* one slot per thread and event, -1 if the event could not be opened */
+static int *perf_fd = NULL;
+static int perf_nthreads = 0;
+static int perf_failed = 0;
+
+static void perf_attr(struct perf_event_attr *attr, int event){
+
+  memset(attr, 0, sizeof(struct perf_event_attr));
+  attr->size = sizeof(struct perf_event_attr);
+  attr->disabled = (event % PERF_GROUP_SIZE == 0);
+  attr->exclude_kernel = 1;
+  attr->exclude_hv = 1;
+  attr->read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  switch (event) {
+  case PERF_CYCLES:
+    attr->type = PERF_TYPE_HARDWARE;
+    attr->config = PERF_COUNT_HW_CPU_CYCLES;
+    break;
+  case PERF_INSTRUCTIONS:
+    attr->type = PERF_TYPE_HARDWARE;
+    attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+    break;
+  case PERF_BRANCH_MISS:
+    attr->type = PERF_TYPE_HARDWARE;
+    attr->config = PERF_COUNT_HW_BRANCH_MISSES;
+    break;
+  case PERF_L1D_MISS:
+    attr->type = PERF_TYPE_HW_CACHE;
+    attr->config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    break;
+  case PERF_LLC_MISS:
+    attr->type = PERF_TYPE_HW_CACHE;
+    attr->config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    break;
+  case PERF_DTLB_MISS:
+    attr->type = PERF_TYPE_HW_CACHE;
+    attr->config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    break;
+  }
+}
+
+static void perf_close(){
+
+  int i;
+
+  if (!perf_fd) return;
+  for (i = 0; i < perf_nthreads * PERF_NEVENTS; i++) {
+    if (perf_fd[i] >= 0) close(perf_fd[i]);
+  }
+  free(perf_fd);
+  perf_fd = NULL;
+  perf_nthreads = 0;
+}
+
+/* open the groups on every thread of the current team size */
+static int perf_open(){
+
+  int nthreads = omp_get_max_threads();
+  int opened = 0, err = 0;
+  int i;
+
+  perf_close();
+
+  perf_fd = (int *)malloc(nthreads * PERF_NEVENTS * sizeof(int));
+  if (!perf_fd) return 1;
+  for (i = 0; i < nthreads * PERF_NEVENTS; i++) perf_fd[i] = -1;
+  perf_nthreads = nthreads;
+
+  # pragma omp parallel reduction(+:opened) reduction(max:err)
+  {
+    struct perf_event_attr attr;
+    int *fd = perf_fd + omp_get_thread_num() * PERF_NEVENTS;
+    int e, leader;
+
+    for (e = 0; e < PERF_NEVENTS; e++) {
+      leader = (e % PERF_GROUP_SIZE == 0) ? -1 : fd[e - e % PERF_GROUP_SIZE];
+      /* no point opening members of a group without a leader */
+      if (e % PERF_GROUP_SIZE != 0 && leader < 0) continue;
+
+      perf_attr(&attr, e);
+      fd[e] = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+      if (fd[e] >= 0) opened++;
+      else if (errno > err) err = errno;
+    }
+  }
+
+  if (opened == 0) {
+    fprintf(stderr, "WARNING: unable to open hardware performance counters (%s), "
+            "continuing without them. Check /proc/sys/kernel/perf_event_paranoid.\n", strerror(err));
+    perf_close();
+    return 1;
+  }
+
+  return 0;
+}
+
+void perf_start(){
+
+  int i;
+
+  if (!perf_enabled || perf_failed) return;
+
+  if (perf_nthreads != omp_get_max_threads() && perf_open()) {
+    perf_failed = 1;
+    return;
+  }
+
+  for (i = 0; i < perf_nthreads * PERF_NEVENTS; i += PERF_GROUP_SIZE) {
+    if (perf_fd[i] < 0) continue;
+    ioctl(perf_fd[i], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(perf_fd[i], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+/* stop counting and store the counts of one sample, summed over all */
+/* threads, in counts[]; events that are unavailable are set to -1   */
+int perf_stop(double *counts){
+
+  unsigned long long buf[3 + PERF_GROUP_SIZE];
+  int have[PERF_NEVENTS];
+  int t, g, e;
+  unsigned long long k;
+  double scale;
+
+  if (!perf_enabled || perf_failed || !perf_fd) return 0;
+
+  for (e = 0; e < PERF_NEVENTS; e++) {
+    have[e] = 0;
+    counts[e] = 0.0;
+  }
+
+  for (t = 0; t < perf_nthreads; t++) {
+    int *fd = perf_fd + t * PERF_NEVENTS;
+    for (g = 0; g < PERF_NGROUPS; g++) {
+      int lead = g * PERF_GROUP_SIZE;
+      if (fd[lead] < 0) continue;
+      ioctl(fd[lead], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+      if (read(fd[lead], buf, sizeof(buf)) < (ssize_t)(3 * sizeof(unsigned long long))) continue;
+
+      /* buf = { nr, time_enabled, time_running, value[nr] }, scale if multiplexed */
+      scale = (buf[2] > 0) ? (double)buf[1] / buf[2] : 0.0;
+      for (e = lead, k = 0; e < lead + PERF_GROUP_SIZE && k < buf[0]; e++) {
+        if (fd[e] < 0) continue;
+        counts[e] += buf[3 + k] * scale;
+        have[e] = 1;
+        k++;
+      }
+    }
+  }
+
+  for (e = 0; e < PERF_NEVENTS; e++) {
+    if (!have[e]) counts[e] = -1;
+  }
+
+  return 1;
+}
+
+#else
+
+void perf_start(){
+  if (perf_enabled) {
+    fprintf(stderr, "WARNING: hardware performance counters are only supported on Linux.\n");
+    perf_enabled = 0;
+  }
+}
+
+int perf_stop(double *counts){
+  return 0;
+}
+
+#endif
@@ -0,0 +1,48 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#ifndef PERFCTR_H
+#define PERFCTR_H
+
+/*
+ * Hardware performance counters around timed regions. When enabled with
+ * --counters, every OpenMP thread opens two perf_event groups on itself:
+ * {cycles, instructions, branch-misses} and {L1D read misses, LLC read
+ * misses, dTLB read misses}. The sampler enables the groups when a sample
+ * starts and reads them when it stops; counts are summed over threads.
+ * If the kernel refuses access (perf_event_paranoid, seccomp, no PMU)
+ * a warning is printed once and the benchmarks run without counters.
+ */
+
+#define PERF_CYCLES       0
+#define PERF_INSTRUCTIONS 1
+#define PERF_BRANCH_MISS  2
+#define PERF_L1D_MISS     3
+#define PERF_LLC_MISS     4
+#define PERF_DTLB_MISS    5
+#define PERF_NEVENTS      6
+
+extern int perf_enabled;
+extern char *perf_event_names[PERF_NEVENTS];
+
+void perf_start();
+int perf_stop(double *);
+
+#endif
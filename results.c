@@ -0,0 +1,742 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/utsname.h>
+#include <omp.h>
+
+#include "utils.h"
+#include "timer.h"
+#include "perfctr.h"
+#include "affinity.h"
+#include "numa.h"
+#include "rng.h"
+#include "pages.h"
+#include "results.h"
+
+int results_format = RESULTS_TEXT;
+
+static FILE *results_out = NULL;
+static int csv_header_done = 0;
+
+/* what is being run, set by the driver */
+static char *ctx_bench = "";
+static char *ctx_op = "";
+static char *ctx_dtype = "";
+static unsigned long ctx_size = 0;
+static unsigned long ctx_stride = 0;
+
+/* regions recorded during a thread-count sweep */
+typedef struct {
+  char *title;
+  int threads;
+  double median, ops_rate, gb_rate;
+} sweep_point_t;
+
+static int sweep_active = 0;
+static sweep_point_t *sweep = NULL;
+static int sweep_n = 0, sweep_cap = 0;
+static int *sweep_start = NULL;   /* index of the first point of each step */
+static int sweep_steps = 0;
+
+static struct utsname host;
+static int host_done = 0;
+static char timestamp[32];
+
+int results_set_format(char *f){
+
+  if (strcmp(f, "text") == 0) results_format = RESULTS_TEXT;
+  else if (strcmp(f, "json") == 0) results_format = RESULTS_JSON;
+  else if (strcmp(f, "csv") == 0) results_format = RESULTS_CSV;
+  else {
+    fprintf(stderr, "ERROR: unknown output format %s, use text, json or csv\n", f);
+    return 1;
+  }
+
+  return 0;
+}
+
+int results_open(char *path){
+
+  results_out = fopen(path, "w");
+  if (!results_out) {
+    fprintf(stderr, "ERROR: unable to open %s for writing results\n", path);
+    return 1;
+  }
+
+  return 0;
+}
+
+void results_close(){
+  if (results_out && results_out != stdout) fclose(results_out);
+  results_out = NULL;
+}
+
+void results_set_context(char *b, char *o, char *dt, unsigned long s, unsigned long t){
+  ctx_bench = b;
+  ctx_op = o;
+  ctx_dtype = dt;
+  ctx_size = s;
+  ctx_stride = t;
+}
+
+static void host_metadata(){
+
+  time_t now;
+
+  if (host_done) return;
+  host_done = 1;
+
+  if (uname(&host) != 0) memset(&host, 0, sizeof(host));
+
+  now = time(NULL);
+  strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+}
+
+/* write a string with JSON escaping */
+static void json_string(FILE *f, char *str){
+
+  fputc('"', f);
+  for (; *str; str++) {
+    if (*str == '"' || *str == '\\') fputc('\\', f);
+    if ((unsigned char)*str < 0x20) fputc(' ', f);
+    else fputc(*str, f);
+  }
+  fputc('"', f);
+}
+
+/* write a string as a quoted CSV field */
+static void csv_string(FILE *f, char *str){
+
+  fputc('"', f);
+  for (; *str; str++) {
+    if (*str == '"') fputc('"', f);
+    fputc(*str, f);
+  }
+  fputc('"', f);
+}
+
+/* derived counter metrics: IPC, misses per kilo-instruction and per op */
+static double counter_ipc(double *c){
+  if (!c || c[PERF_CYCLES] <= 0 || c[PERF_INSTRUCTIONS] < 0) return -1;
+  return c[PERF_INSTRUCTIONS] / c[PERF_CYCLES];
+}
+
+static double counter_mpki(double *c, int e){
+  if (!c || c[e] < 0 || c[PERF_INSTRUCTIONS] <= 0) return -1;
+  return 1000.0 * c[e] / c[PERF_INSTRUCTIONS];
+}
+
+static double counter_per_op(double *c, int e, double ops){
+  if (!c || c[e] < 0 || ops <= 0) return -1;
+  return c[e] / ops;
+}
+
+/* write a JSON number, or null for an unavailable value */
+static void json_value(FILE *f, char *key, double v){
+  if (v < 0) fprintf(f, ", \"%s\": null", key);
+  else fprintf(f, ", \"%s\": %.6e", key, v);
+}
+
+/* write a CSV number, or an empty field for an unavailable value */
+static void csv_value(FILE *f, double v){
+  if (v < 0) fprintf(f, ",");
+  else fprintf(f, ",%.6e", v);
+}
+
+/* everything reported for one sampled region */
+typedef struct {
+  char *title;
+  sample_stats_t *st;
+  unsigned long reps;
+  double ops, bytes;            /* work done by one sample */
+  double ops_rate, gb_rate;     /* derived from the median sample */
+  double cycles_op;
+  double latency;               /* seconds per dependent operation, or 0 */
+  double *c;                    /* mean counter values per sample, or NULL */
+  double counts[PERF_NEVENTS];
+  int nthreads;                 /* threads with their own timestamps, or 0 */
+  double *thread_s;             /* mean duration per thread */
+  double slowest, fastest;      /* mean duration of the slowest/fastest thread */
+  double ops_rate_slow, gb_rate_slow;
+  int nnodes;                   /* memory nodes with per-node bandwidth, or 0 */
+  double *node_gb;              /* GB/s of the threads whose arrays are on a node, -1 if none */
+} record_t;
+
+static void text_record(FILE *f, record_t *r){
+
+  sample_stats_t *st = r->st;
+  double *c = r->c;
+  double rel = 0.0;
+  int e, t;
+
+  if (st->mean > 0.0) rel = 100.0 * (st->ci_hi - st->mean) / st->mean;
+
+  fprintf(f, "\n--- %s\n", r->title);
+  fprintf(f, "--- Timings ------------------------------------------------------------------------\n");
+  fprintf(f, "|\n");
+  fprintf(f, "| Samples: %u   ", st->n);
+  fprintf(f, "Min: %.9lf   ", st->min);
+  fprintf(f, "Median: %.9lf   ", st->median);
+  fprintf(f, "Mean: %.9lf s\n", st->mean);
+  fprintf(f, "| P90: %.9lf   ", st->p90);
+  fprintf(f, "P99: %.9lf   ", st->p99);
+  fprintf(f, "Max: %.9lf   ", st->max);
+  fprintf(f, "Stddev: %.9lf s\n", st->stddev);
+  if (r->reps && st->min > 0.0) {
+    fprintf(f, "| Iterations per sample: %lu   ", r->reps);
+    fprintf(f, "Timer resolution error below %.2e of a sample\n", timer_resolution() / st->min);
+  }
+  fprintf(f, "| 95%% CI: [%.9lf, %.9lf] s (+/- %.2lf%%)\n", st->ci_lo, st->ci_hi, rel);
+  if (r->ops_rate > 0.0 && r->gb_rate > 0.0) {
+    fprintf(f, "| Rate (median): %.6e ops/s   %.6lf GB/s\n", r->ops_rate, r->gb_rate);
+  }
+  else if (r->ops_rate > 0.0) {
+    fprintf(f, "| Rate (median): %.6e ops/s\n", r->ops_rate);
+  }
+  else if (r->gb_rate > 0.0) {
+    fprintf(f, "| Rate (median): %.6lf GB/s\n", r->gb_rate);
+  }
+  if (r->cycles_op > 0.0) {
+    fprintf(f, "| Cycles per op (median, TSC reference cycles): %.3lf\n", r->cycles_op);
+  }
+  if (r->latency > 0.0) {
+    fprintf(f, "| Latency (median): %.3lf ns per dependent op   %.1lf TSC reference cycles\n",
+            r->latency * 1e9, r->latency * timer_cycle_hz);
+  }
+  if (r->nthreads) {
+    fprintf(f, "| Per-thread (mean): slowest %.9lf s   fastest %.9lf s   max/min %.3lf\n",
+            r->slowest, r->fastest, r->fastest > 0.0 ? r->slowest / r->fastest : 0.0);
+    fprintf(f, "|  ");
+    for (t = 0; t < r->nthreads; t++) {
+      fprintf(f, " T%d %.9lf", t, r->thread_s[t]);
+      if (t % 6 == 5 && t + 1 < r->nthreads) fprintf(f, "\n|  ");
+    }
+    fprintf(f, "\n");
+    if (r->ops_rate_slow > 0.0 || r->gb_rate_slow > 0.0) {
+      fprintf(f, "| Rate (slowest thread): %.6e ops/s   %.6lf GB/s\n", r->ops_rate_slow, r->gb_rate_slow);
+    }
+  }
+  if (r->nnodes) {
+    fprintf(f, "| Bandwidth per memory node (--numa %s):", numa_name);
+    for (t = 0; t < r->nnodes; t++) {
+      if (r->node_gb[t] >= 0) fprintf(f, "  node %d %.6lf GB/s", t, r->node_gb[t]);
+    }
+    fprintf(f, "\n");
+  }
+  if (c) {
+    fprintf(f, "| Counters per sample:");
+    for (e = 0; e < PERF_NEVENTS; e++) {
+      if (c[e] >= 0) fprintf(f, "  %s %.0f", perf_event_names[e], c[e]);
+    }
+    fprintf(f, "\n");
+    if (counter_ipc(c) >= 0) fprintf(f, "| IPC: %.3lf", counter_ipc(c));
+    else fprintf(f, "| IPC: n/a");
+    for (e = PERF_BRANCH_MISS; e < PERF_NEVENTS; e++) {
+      if (counter_mpki(c, e) >= 0) fprintf(f, "   %s MPKI: %.3lf", perf_event_names[e], counter_mpki(c, e));
+      if (counter_per_op(c, e, r->ops) >= 0) fprintf(f, " (%.4lf/op)", counter_per_op(c, e, r->ops));
+    }
+    fprintf(f, "\n");
+  }
+  fprintf(f, "|\n");
+  fprintf(f, "------------------------------------------------------------------------------------\n");
+}
+
+/* write the binding and the placement of every thread */
+static void json_placement(FILE *f){
+
+  cpu_place_t *p;
+  int t;
+
+  fprintf(f, ", \"bind\": ");     json_string(f, affinity_name);
+  fprintf(f, ", \"placement\": [");
+  for (t = 0; t < affinity_threads(); t++) {
+    p = affinity_thread(t);
+    fprintf(f, "%s{\"cpu\": %d, \"socket\": %d, \"core\": %d, \"smt\": %d}",
+            t ? ", " : "", p->cpu, p->socket, p->core, p->smt);
+  }
+  fprintf(f, "]");
+}
+
+static void json_record(FILE *f, record_t *r){
+
+  sample_stats_t *st = r->st;
+  double *c = r->c;
+  int e, t;
+  char key[64];
+
+  fprintf(f, "{\"benchmark\": ");  json_string(f, ctx_bench);
+  fprintf(f, ", \"op\": ");        json_string(f, ctx_op);
+  fprintf(f, ", \"dtype\": ");     json_string(f, ctx_dtype);
+  fprintf(f, ", \"size\": %lu, \"stride\": %lu, \"threads\": %d",
+          ctx_size, ctx_stride, omp_get_max_threads());
+  fprintf(f, ", \"region\": ");    json_string(f, r->title);
+  fprintf(f, ", \"samples\": %u, \"reps\": %lu", st->n, r->reps);
+  fprintf(f, ", \"min_s\": %.9e, \"median_s\": %.9e, \"mean_s\": %.9e", st->min, st->median, st->mean);
+  fprintf(f, ", \"p90_s\": %.9e, \"p99_s\": %.9e, \"max_s\": %.9e", st->p90, st->p99, st->max);
+  fprintf(f, ", \"stddev_s\": %.9e, \"ci95_lo_s\": %.9e, \"ci95_hi_s\": %.9e", st->stddev, st->ci_lo, st->ci_hi);
+  fprintf(f, ", \"ops\": %.0f, \"bytes\": %.0f", r->ops, r->bytes);
+  fprintf(f, ", \"ops_per_s\": %.6e, \"gb_per_s\": %.6e", r->ops_rate, r->gb_rate);
+  if (strcmp(ctx_bench, "io") == 0) fprintf(f, ", \"iops\": %.6e", r->ops_rate);
+  fprintf(f, ", \"cycles_per_op\": %.6e", r->cycles_op);
+  if (r->latency > 0.0) {
+    fprintf(f, ", \"latency_ns\": %.6e, \"latency_cycles\": %.6e", r->latency * 1e9, r->latency * timer_cycle_hz);
+  }
+  fprintf(f, ", \"timer\": \"%s\"", timer_backend == TIMER_TSC ? "tsc" : "clock");
+  json_placement(f);
+  fprintf(f, ", \"numa\": ");     json_string(f, numa_name);
+  fprintf(f, ", \"pages\": ");    json_string(f, pages_name);
+  fprintf(f, ", \"seed\": %llu", rng_seed);
+  if (r->nnodes) {
+    fprintf(f, ", \"node_gb_per_s\": [");
+    for (t = 0; t < r->nnodes; t++) {
+      if (r->node_gb[t] >= 0) fprintf(f, "%s%.6e", t ? ", " : "", r->node_gb[t]);
+      else fprintf(f, "%snull", t ? ", " : "");
+    }
+    fprintf(f, "]");
+  }
+  if (r->nthreads) {
+    fprintf(f, ", \"thread_s\": [");
+    for (t = 0; t < r->nthreads; t++) fprintf(f, "%s%.9e", t ? ", " : "", r->thread_s[t]);
+    fprintf(f, "], \"slowest_thread_s\": %.9e, \"fastest_thread_s\": %.9e", r->slowest, r->fastest);
+    json_value(f, "thread_imbalance", r->fastest > 0.0 ? r->slowest / r->fastest : -1);
+    fprintf(f, ", \"ops_per_s_slowest\": %.6e, \"gb_per_s_slowest\": %.6e", r->ops_rate_slow, r->gb_rate_slow);
+  }
+  if (c) {
+    for (e = 0; e < PERF_NEVENTS; e++) json_value(f, perf_event_names[e], c[e]);
+    json_value(f, "ipc", counter_ipc(c));
+    for (e = PERF_BRANCH_MISS; e < PERF_NEVENTS; e++) {
+      sprintf(key, "%s_mpki", perf_event_names[e]);
+      json_value(f, key, counter_mpki(c, e));
+      sprintf(key, "%s_per_op", perf_event_names[e]);
+      json_value(f, key, counter_per_op(c, e, r->ops));
+    }
+  }
+  fprintf(f, ", \"host\": ");      json_string(f, host.nodename);
+  fprintf(f, ", \"os\": ");        json_string(f, host.release);
+  fprintf(f, ", \"arch\": ");      json_string(f, host.machine);
+  fprintf(f, ", \"timestamp\": "); json_string(f, timestamp);
+  fprintf(f, "}\n");
+}
+
+static void csv_record(FILE *f, record_t *r){
+
+  sample_stats_t *st = r->st;
+  double *c = r->c;
+  cpu_place_t *p;
+  int e, t;
+
+  if (!csv_header_done) {
+    csv_header_done = 1;
+    fprintf(f, "benchmark,op,dtype,size,stride,threads,region,samples,reps,"
+            "min_s,median_s,mean_s,p90_s,p99_s,max_s,stddev_s,ci95_lo_s,ci95_hi_s,"
+            "ops,bytes,ops_per_s,gb_per_s,cycles_per_op,timer,host,os,arch,timestamp,"
+            "thread_s,slowest_thread_s,fastest_thread_s,thread_imbalance,"
+            "ops_per_s_slowest,gb_per_s_slowest,bind,placement,numa,pages,node_gb_per_s,seed,latency_ns");
+    for (e = 0; e < PERF_NEVENTS; e++) fprintf(f, ",%s", perf_event_names[e]);
+    fprintf(f, ",ipc");
+    for (e = PERF_BRANCH_MISS; e < PERF_NEVENTS; e++) {
+      fprintf(f, ",%s_mpki,%s_per_op", perf_event_names[e], perf_event_names[e]);
+    }
+    fprintf(f, "\n");
+  }
+
+  csv_string(f, ctx_bench);  fputc(',', f);
+  csv_string(f, ctx_op);     fputc(',', f);
+  csv_string(f, ctx_dtype);
+  fprintf(f, ",%lu,%lu,%d,", ctx_size, ctx_stride, omp_get_max_threads());
+  csv_string(f, r->title);
+  fprintf(f, ",%u,%lu", st->n, r->reps);
+  fprintf(f, ",%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e",
+          st->min, st->median, st->mean, st->p90, st->p99, st->max,
+          st->stddev, st->ci_lo, st->ci_hi);
+  fprintf(f, ",%.0f,%.0f,%.6e,%.6e,%.6e,%s,", r->ops, r->bytes, r->ops_rate, r->gb_rate, r->cycles_op,
+          timer_backend == TIMER_TSC ? "tsc" : "clock");
+  csv_string(f, host.nodename); fputc(',', f);
+  csv_string(f, host.release);  fputc(',', f);
+  csv_string(f, host.machine);  fputc(',', f);
+  csv_string(f, timestamp);
+
+  /* per-thread durations go in one field separated by semicolons */
+  fputc(',', f);
+  if (r->nthreads) {
+    for (t = 0; t < r->nthreads; t++) fprintf(f, "%s%.9e", t ? ";" : "", r->thread_s[t]);
+  }
+  csv_value(f, r->nthreads ? r->slowest : -1);
+  csv_value(f, r->nthreads ? r->fastest : -1);
+  csv_value(f, (r->nthreads && r->fastest > 0.0) ? r->slowest / r->fastest : -1);
+  csv_value(f, r->nthreads ? r->ops_rate_slow : -1);
+  csv_value(f, r->nthreads ? r->gb_rate_slow : -1);
+
+  /* placement as cpu:socket:core:smt for every thread */
+  fputc(',', f);
+  csv_string(f, affinity_name);
+  fputc(',', f);
+  for (t = 0; t < affinity_threads(); t++) {
+    p = affinity_thread(t);
+    fprintf(f, "%s%d:%d:%d:%d", t ? ";" : "", p->cpu, p->socket, p->core, p->smt);
+  }
+  fputc(',', f);
+  csv_string(f, numa_name);
+  fputc(',', f);
+  csv_string(f, pages_name);
+  fputc(',', f);
+  for (t = 0; t < r->nnodes; t++) {
+    if (t) fputc(';', f);
+    if (r->node_gb[t] >= 0) fprintf(f, "%.6e", r->node_gb[t]);
+  }
+  fprintf(f, ",%llu", rng_seed);
+  csv_value(f, r->latency > 0.0 ? r->latency * 1e9 : -1);
+
+  for (e = 0; e < PERF_NEVENTS; e++) csv_value(f, c ? c[e] : -1);
+  csv_value(f, counter_ipc(c));
+  for (e = PERF_BRANCH_MISS; e < PERF_NEVENTS; e++) {
+    csv_value(f, counter_mpki(c, e));
+    csv_value(f, counter_per_op(c, e, r->ops));
+  }
+  fputc('\n', f);
+}
+
+static void sweep_add(record_t *r){
+
+  sweep_point_t *p;
+
+  if (sweep_n == sweep_cap) {
+    sweep_cap = sweep_cap ? 2 * sweep_cap : 64;
+    p = (sweep_point_t *)realloc(sweep, sweep_cap * sizeof(sweep_point_t));
+    if (!p) {
+      fprintf(stderr, "ERROR: out of memory recording the thread sweep\n");
+      sweep_cap = sweep_n;
+      return;
+    }
+    sweep = p;
+  }
+
+  p = &sweep[sweep_n];
+  p->title = strdup(r->title);
+  if (!p->title) return;
+  sweep_n++;
+  p->threads = omp_get_max_threads();
+  p->median = r->st->median;
+  p->ops_rate = r->ops_rate;
+  p->gb_rate = r->gb_rate;
+}
+
+/* report one sampled region */
+void results_record(sampler_t *s, sample_stats_t *st){
+
+  record_t r;
+  FILE *f = results_out ? results_out : stdout;
+  int e, t;
+
+  memset(&r, 0, sizeof(r));
+  r.title = s->title;
+  r.st = st;
+  r.reps = s->reps ? *s->reps : 0;
+  r.ops = s->ops;
+  r.bytes = s->bytes;
+
+  if (st->median > 0.0) {
+    r.ops_rate = r.ops / st->median;
+    r.gb_rate = r.bytes / st->median / 1e9;
+  }
+  if (r.ops > 0.0) r.cycles_op = st->median * timer_cycle_hz / r.ops;
+  if (s->chain > 0.0) r.latency = st->median / s->chain;
+
+  /* counters are reported as the mean per sample */
+  if (s->counted) {
+    for (e = 0; e < PERF_NEVENTS; e++) {
+      r.counts[e] = (s->counts[e] >= 0) ? s->counts[e] / s->counted : -1;
+    }
+    r.c = r.counts;
+  }
+
+  /* per-thread durations, throughput is limited by the slowest thread */
+  if (s->timed && s->nthreads_seen) {
+    r.nthreads = s->nthreads_seen;
+    r.thread_s = (double *)malloc(r.nthreads * sizeof(double));
+    if (r.thread_s) {
+      for (t = 0; t < r.nthreads; t++) r.thread_s[t] = s->thread_sum[t] / s->timed;
+      r.slowest = s->slowest_sum / s->timed;
+      r.fastest = s->fastest_sum / s->timed;
+      if (r.slowest > 0.0) {
+        r.ops_rate_slow = r.ops / r.slowest;
+        r.gb_rate_slow = r.bytes / r.slowest / 1e9;
+      }
+    }
+    else r.nthreads = 0;
+  }
+
+  /* bandwidth per memory node, from the threads whose arrays live there */
+  if (r.nthreads && r.bytes > 0.0 && numa_thread_node(0) >= 0) {
+    r.nnodes = numa_nodes();
+    r.node_gb = (double *)malloc(r.nnodes * sizeof(double));
+    if (r.node_gb) {
+      for (t = 0; t < r.nnodes; t++) r.node_gb[t] = -1;
+      for (t = 0; t < r.nthreads; t++) {
+        e = numa_thread_node(t);
+        if (e < 0 || e >= r.nnodes || r.thread_s[t] <= 0.0) continue;
+        if (r.node_gb[e] < 0) r.node_gb[e] = 0.0;
+        r.node_gb[e] += r.bytes / r.nthreads / r.thread_s[t] / 1e9;
+      }
+    }
+    else r.nnodes = 0;
+  }
+
+  host_metadata();
+
+  switch (results_format) {
+  case RESULTS_JSON:
+    json_record(f, &r);
+    break;
+  case RESULTS_CSV:
+    csv_record(f, &r);
+    break;
+  default:
+    text_record(f, &r);
+    break;
+  }
+  fflush(f);
+
+  if (sweep_active) sweep_add(&r);
+
+  free(r.thread_s);
+  free(r.node_gb);
+}
+
+void results_sweep_begin(){
+  sweep_active = 1;
+  sweep_n = 0;
+  sweep_steps = 0;
+}
+
+void results_sweep_step(){
+
+  int *p = (int *)realloc(sweep_start, (sweep_steps + 1) * sizeof(int));
+
+  if (!p) {
+    fprintf(stderr, "ERROR: out of memory in results_sweep_step\n");
+    return;
+  }
+  sweep_start = p;
+  sweep_start[sweep_steps++] = sweep_n;
+}
+
+/* throughput of a point: ops/s, else GB/s, else inverse runtime */
+static double sweep_rate(sweep_point_t *p){
+  if (p->ops_rate > 0.0) return p->ops_rate;
+  if (p->gb_rate > 0.0) return p->gb_rate;
+  if (p->median > 0.0) return 1.0 / p->median;
+  return 0.0;
+}
+
+/* the k-th region of a step, or NULL if that step recorded fewer regions */
+static sweep_point_t *sweep_point(int step, int k){
+
+  int end = (step + 1 < sweep_steps) ? sweep_start[step + 1] : sweep_n;
+
+  if (sweep_start[step] + k >= end) return NULL;
+  return &sweep[sweep_start[step] + k];
+}
+
+static void sweep_text(FILE *f, int k){
+
+  sweep_point_t *base = sweep_point(0, k), *p;
+  double speedup;
+  int j;
+
+  fprintf(f, "\n--- Thread scaling: %s\n", base->title);
+  fprintf(f, "------------------------------------------------------------------------------------\n");
+  fprintf(f, "| Threads     Median (s)   Speedup  Efficiency          ops/s           GB/s\n");
+  for (j = 0; j < sweep_steps; j++) {
+    p = sweep_point(j, k);
+    if (!p || strcmp(p->title, base->title) != 0) continue;
+    speedup = sweep_rate(base) > 0.0 ? sweep_rate(p) / sweep_rate(base) : 0.0;
+    fprintf(f, "| %7d %14.9lf %9.3lf %11.3lf %14.6e %14.6lf\n", p->threads, p->median,
+            speedup, speedup * base->threads / p->threads, p->ops_rate, p->gb_rate);
+  }
+  fprintf(f, "------------------------------------------------------------------------------------\n");
+}
+
+static void sweep_json(FILE *f, int k){
+
+  sweep_point_t *base = sweep_point(0, k), *p;
+  double speedup;
+  int j, first = 1;
+
+  fprintf(f, "{\"benchmark\": ");  json_string(f, ctx_bench);
+  fprintf(f, ", \"op\": ");        json_string(f, ctx_op);
+  fprintf(f, ", \"dtype\": ");     json_string(f, ctx_dtype);
+  fprintf(f, ", \"size\": %lu, \"stride\": %lu", ctx_size, ctx_stride);
+  fprintf(f, ", \"region\": ");    json_string(f, base->title);
+  fprintf(f, ", \"scaling\": [");
+  for (j = 0; j < sweep_steps; j++) {
+    p = sweep_point(j, k);
+    if (!p || strcmp(p->title, base->title) != 0) continue;
+    speedup = sweep_rate(base) > 0.0 ? sweep_rate(p) / sweep_rate(base) : 0.0;
+    fprintf(f, "%s{\"threads\": %d, \"median_s\": %.9e, \"speedup\": %.6e, \"efficiency\": %.6e",
+            first ? "" : ", ", p->threads, p->median, speedup, speedup * base->threads / p->threads);
+    fprintf(f, ", \"ops_per_s\": %.6e, \"gb_per_s\": %.6e", p->ops_rate, p->gb_rate);
+    if (strcmp(ctx_bench, "io") == 0) fprintf(f, ", \"iops\": %.6e", p->ops_rate);
+    fprintf(f, "}");
+    first = 0;
+  }
+  fprintf(f, "]}\n");
+}
+
+static void sweep_csv(FILE *f, int k){
+
+  sweep_point_t *base = sweep_point(0, k), *p;
+  double speedup;
+  int j;
+
+  for (j = 0; j < sweep_steps; j++) {
+    p = sweep_point(j, k);
+    if (!p || strcmp(p->title, base->title) != 0) continue;
+    speedup = sweep_rate(base) > 0.0 ? sweep_rate(p) / sweep_rate(base) : 0.0;
+    csv_string(f, ctx_bench);  fputc(',', f);
+    csv_string(f, ctx_op);     fputc(',', f);
+    csv_string(f, ctx_dtype);
+    fprintf(f, ",%lu,%lu,", ctx_size, ctx_stride);
+    csv_string(f, base->title);
+    fprintf(f, ",%d,%.9e,%.6e,%.6e,%.6e,%.6e\n", p->threads, p->median, speedup,
+            speedup * base->threads / p->threads, p->ops_rate, p->gb_rate);
+  }
+}
+
+/*
+ * Speedup is the throughput of a step over that of the first step, so it
+ * holds for the weak-scaled benchmarks (every thread does the full work)
+ * as well as for fixed total work; efficiency divides it by the ratio of
+ * thread counts.
+ */
+void results_sweep_end(){
+
+  FILE *f = results_out ? results_out : stdout;
+  int k, nregions;
+
+  if (sweep_steps > 0) {
+    nregions = (sweep_steps > 1 ? sweep_start[1] : sweep_n) - sweep_start[0];
+    if (results_format == RESULTS_CSV)
+      fprintf(f, "benchmark,op,dtype,size,stride,region,threads,median_s,speedup,efficiency,ops_per_s,gb_per_s\n");
+    for (k = 0; k < nregions; k++) {
+      if (results_format == RESULTS_JSON) sweep_json(f, k);
+      else if (results_format == RESULTS_CSV) sweep_csv(f, k);
+      else sweep_text(f, k);
+    }
+    fflush(f);
+    /* records written after the block start with their header again */
+    if (results_format == RESULTS_CSV) csv_header_done = 0;
+  }
+
+  for (k = 0; k < sweep_n; k++) free(sweep[k].title);
+  free(sweep);
+  free(sweep_start);
+  sweep = NULL;
+  sweep_start = NULL;
+  sweep_n = sweep_cap = sweep_steps = 0;
+  sweep_active = 0;
+}
+
+
+/*
+ * A matrix of values between pairs of threads, row-major with n rows of
+ * n, negative for pairs not measured. In json mode it is one object with
+ * the placement of the threads, in csv mode a block with its own header
+ * and one row per measured pair; in text mode it is printed as a table.
+ */
+void results_matrix(char *title, char *unit, int n, double *m){
+
+  FILE *f = results_out ? results_out : stdout;
+  cpu_place_t *p;
+  int i, j;
+  char label[16];
+
+  host_metadata();
+
+  if (results_format == RESULTS_JSON) {
+    fprintf(f, "{\"benchmark\": ");  json_string(f, ctx_bench);
+    fprintf(f, ", \"op\": ");        json_string(f, ctx_op);
+    fprintf(f, ", \"threads\": %d", n);
+    fprintf(f, ", \"region\": ");    json_string(f, title);
+    fprintf(f, ", \"unit\": ");      json_string(f, unit);
+    json_placement(f);
+    fprintf(f, ", \"matrix\": [");
+    for (i = 0; i < n; i++) {
+      fprintf(f, "%s[", i ? ", " : "");
+      for (j = 0; j < n; j++) {
+        if (m[i * n + j] >= 0) fprintf(f, "%s%.6e", j ? ", " : "", m[i * n + j]);
+        else fprintf(f, "%snull", j ? ", " : "");
+      }
+      fprintf(f, "]");
+    }
+    fprintf(f, "]");
+    fprintf(f, ", \"host\": ");      json_string(f, host.nodename);
+    fprintf(f, ", \"timestamp\": "); json_string(f, timestamp);
+    fprintf(f, "}\n");
+    fflush(f);
+    return;
+  }
+
+  if (results_format == RESULTS_CSV) {
+    fprintf(f, "benchmark,op,region,row,col,row_cpu,col_cpu,value,unit\n");
+    for (i = 0; i < n; i++) {
+      for (j = 0; j < n; j++) {
+        if (m[i * n + j] < 0) continue;
+        csv_string(f, ctx_bench);  fputc(',', f);
+        csv_string(f, ctx_op);     fputc(',', f);
+        csv_string(f, title);
+        fprintf(f, ",%d,%d,%d,%d,%.6e,", i, j,
+                i < affinity_threads() ? affinity_thread(i)->cpu : -1,
+                j < affinity_threads() ? affinity_thread(j)->cpu : -1, m[i * n + j]);
+        csv_string(f, unit);
+        fputc('\n', f);
+      }
+    }
+    fflush(f);
+    /* records written after the block start with their header again */
+    csv_header_done = 0;
+    return;
+  }
+
+  fprintf(f, "\n--- %s (%s)\n", title, unit);
+  fprintf(f, "------------------------------------------------------------------------------------\n");
+  fprintf(f, "| %-12s", "");
+  for (j = 0; j < n; j++) {
+    sprintf(label, "T%d", j);
+    fprintf(f, " %11s", label);
+  }
+  fprintf(f, "\n");
+  for (i = 0; i < n; i++) {
+    p = (i < affinity_threads()) ? affinity_thread(i) : NULL;
+    if (p) fprintf(f, "| T%-3d cpu %3d", i, p->cpu);
+    else fprintf(f, "| T%-11d", i);
+    for (j = 0; j < n; j++) {
+      if (m[i * n + j] >= 0) fprintf(f, " %11.2lf", m[i * n + j]);
+      else fprintf(f, " %11s", "-");
+    }
+    fprintf(f, "\n");
+  }
+  fprintf(f, "------------------------------------------------------------------------------------\n");
+  fflush(f);
+}
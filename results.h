@@ -0,0 +1,57 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#ifndef RESULTS_H
+#define RESULTS_H
+
+#include "stats.h"
+
+/*
+ * Structured results. Every sampled region is reported through
+ * results_record(); in text mode the usual banner is printed, in json
+ * mode one JSON object per line and in csv mode one row per region is
+ * written to the results stream (stdout unless --output is given).
+ */
+
+#define RESULTS_TEXT 0
+#define RESULTS_JSON 1
+#define RESULTS_CSV  2
+
+extern int results_format;
+
+int results_set_format(char *);
+int results_open(char *);
+void results_close();
+void results_set_context(char *, char *, char *, unsigned long, unsigned long);
+void results_record(sampler_t *, sample_stats_t *);
+void results_matrix(char *, char *, int, double *);
+
+/*
+ * Thread-count sweeps. Between results_sweep_begin() and
+ * results_sweep_end() the rate of every recorded region is kept; each
+ * run of the benchmark starts with results_sweep_step() and the end
+ * prints speedup and parallel efficiency of every region relative to
+ * the first step.
+ */
+void results_sweep_begin();
+void results_sweep_step();
+void results_sweep_end();
+
+#endif
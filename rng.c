@@ -0,0 +1,128 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <omp.h>
+
+#include "rng.h"
+
+unsigned long long rng_seed = 0;
+int rng_precompute = 0;
+
+static int seed_given = 0;
+
+/* the generator of each thread, seeded on first use */
+static rng_t thread_rng;
+static int thread_rng_ready = 0;
+# pragma omp threadprivate(thread_rng, thread_rng_ready)
+
+int rng_set_seed(char *str){
+
+  char *end;
+
+  rng_seed = strtoull(str, &end, 0);
+  if (*str == '\0' || *end != '\0') {
+    fprintf(stderr, "ERROR: invalid seed %s\n", str);
+    return 1;
+  }
+  seed_given = 1;
+
+  return 0;
+}
+
+/* without --seed take the time, and print the seed so the run can be repeated */
+void rng_setup(){
+  if (!seed_given) rng_seed = (unsigned long long)time(NULL);
+  printf("Random seed %llu.\n", rng_seed);
+}
+
+static unsigned long long splitmix64(unsigned long long *x){
+
+  unsigned long long z = (*x += 0x9e3779b97f4a7c15ULL);
+
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+/* seed a generator for one stream, e.g. one thread, of the global seed */
+void rng_init(rng_t *r, unsigned long long stream){
+
+  unsigned long long x = rng_seed ^ (stream * 0xd1b54a32d192ed03ULL);
+  int i;
+
+  for (i = 0; i < 4; i++) r->s[i] = splitmix64(&x);
+}
+
+rng_t *rng_thread(){
+
+  if (!thread_rng_ready) {
+    rng_init(&thread_rng, omp_get_thread_num());
+    thread_rng_ready = 1;
+  }
+
+  return &thread_rng;
+}
+
+/*
+ * With --precompute the random indices are drawn before timing starts:
+ * every thread fills (and so first touches) its own stream of n indices
+ * below range. Returns NULL if memory runs out.
+ */
+size_t **rng_index_streams(int nthreads, size_t n, size_t range){
+
+  size_t **streams = (size_t **)calloc(nthreads, sizeof(size_t *));
+  int failed = 0;
+
+  if (!streams) return NULL;
+
+# pragma omp parallel reduction(+:failed)
+  {
+    int t = omp_get_thread_num();
+    rng_t *r = rng_thread();
+    size_t *s = (size_t *)malloc(n * sizeof(size_t));
+    size_t i;
+
+    if (!s) failed++;
+    else {
+      for (i = 0; i < n; i++) s[i] = rng_below(r, range);
+    }
+    streams[t] = s;
+  }
+
+  if (failed) {
+    rng_free_streams(streams, nthreads);
+    return NULL;
+  }
+
+  return streams;
+}
+
+void rng_free_streams(size_t **streams, int nthreads){
+
+  int t;
+
+  if (!streams) return;
+  for (t = 0; t < nthreads; t++) free(streams[t]);
+  free(streams);
+}
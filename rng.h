@@ -0,0 +1,82 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stddef.h>
+
+/*
+ * Per-thread pseudo-random numbers for the randomized benchmarks.
+ * rand() shares one locked state between all threads, so random access
+ * benchmarks calling it in parallel loops mostly measured contention on
+ * that lock. Instead every thread draws from its own xoshiro256**
+ * generator, seeded with splitmix64 from --seed and the thread number,
+ * so runs with the same seed and thread count repeat the same accesses.
+ */
+
+typedef struct {
+  unsigned long long s[4];
+} rng_t;
+
+extern unsigned long long rng_seed;
+extern int rng_precompute;
+
+int rng_set_seed(char *);
+void rng_setup();
+void rng_init(rng_t *, unsigned long long);
+rng_t *rng_thread();
+size_t **rng_index_streams(int, size_t, size_t);
+void rng_free_streams(size_t **, int);
+
+static inline unsigned long long rng_rotl(unsigned long long x, int k){
+  return (x << k) | (x >> (64 - k));
+}
+
+/* xoshiro256** */
+static inline unsigned long long rng_next(rng_t *r){
+
+  unsigned long long *s = r->s;
+  unsigned long long result = rng_rotl(s[1] * 5, 7) * 9;
+  unsigned long long t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rng_rotl(s[3], 45);
+
+  return result;
+}
+
+/* uniform in [0, n), by multiplying rather than the slower modulo; */
+/* ranges beyond 32 bits need the full 128-bit product              */
+static inline size_t rng_below(rng_t *r, size_t n){
+#ifdef __SIZEOF_INT128__
+  return (size_t)(((unsigned __int128)rng_next(r) * n) >> 64);
+#else
+  if (n <= 0xffffffffULL)
+    return (size_t)(((rng_next(r) >> 32) * (unsigned long long)n) >> 32);
+  return (size_t)(rng_next(r) % n);
+#endif
+}
+
+#endif
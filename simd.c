@@ -0,0 +1,689 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#ifdef __linux__
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#define SIMD_NEON
+#endif
+
+#include "simd.h"
+
+int simd_width = SIMD_ALL;
+int simd_nt = 0;
+int simd_cold = 0;
+
+/* bytes per line flushed by simd_flush, and whether clflushopt is available */
+static size_t flush_line = 0;
+static int flush_opt = 0;
+
+/* keep the compiler from vectorising (or calling memcpy for) the scalar kernels */
+#if defined(__clang__)
+#define SCALAR_KERNEL
+#define SCALAR_LOOP _Pragma("clang loop vectorize(disable) interleave(disable)")
+#elif defined(__GNUC__)
+#define SCALAR_KERNEL __attribute__((optimize("no-tree-vectorize", "no-tree-loop-distribute-patterns")))
+#define SCALAR_LOOP
+#else
+#define SCALAR_KERNEL
+#define SCALAR_LOOP
+#endif
+
+int simd_select(char *w){
+
+  if (strcmp(w, "all") == 0) simd_width = SIMD_ALL;
+  else if (strcmp(w, "scalar") == 0) simd_width = SIMD_SCALAR;
+  else if (strcmp(w, "128") == 0) simd_width = 128;
+  else if (strcmp(w, "256") == 0) simd_width = 256;
+  else if (strcmp(w, "512") == 0) simd_width = 512;
+  else {
+    fprintf(stderr, "ERROR: unknown vector width %s, use all, scalar, 128, 256 or 512\n", w);
+    return 1;
+  }
+
+  if (simd_width != SIMD_ALL && !simd_supported(simd_width)) {
+    fprintf(stderr, "ERROR: %s-bit vectors are not supported on this CPU\n", w);
+    return 1;
+  }
+
+  return 0;
+}
+
+#ifdef SIMD_X86
+static void cpuid(unsigned int leaf, unsigned int sub, unsigned int *r){
+  __asm__ __volatile__ ("cpuid" : "=a" (r[0]), "=b" (r[1]), "=c" (r[2]), "=d" (r[3]) : "a" (leaf), "c" (sub));
+}
+
+/* register state the OS saves on a context switch */
+static unsigned long long xgetbv(){
+  unsigned int lo, hi;
+  __asm__ __volatile__ ("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+  return ((unsigned long long)hi << 32) | lo;
+}
+#endif
+
+/* 1 if vectors of 'bits' bits can be used, the CPU and the OS both have to support them */
+int simd_supported(int bits){
+
+  if (bits == SIMD_SCALAR) return 1;
+
+#ifdef SIMD_X86
+  unsigned int r[4], max;
+  unsigned long long xcr0 = 0;
+
+  cpuid(0, 0, r);
+  max = r[0];
+  cpuid(1, 0, r);
+
+  /* CPUID.1:EDX[26] is SSE2 */
+  if (bits == 128) return (r[3] >> 26) & 1;
+
+  /* AVX needs CPUID.1:ECX[28] and the OS saving XMM and YMM state (OSXSAVE, XCR0[2:1]) */
+  if (!((r[2] >> 27) & 1) || !((r[2] >> 28) & 1)) return 0;
+  xcr0 = xgetbv();
+  if ((xcr0 & 0x6) != 0x6) return 0;
+  if (bits == 256) return 1;
+
+  /* AVX-512F is CPUID.7.0:EBX[16], the OS must also save opmask and ZMM state (XCR0[7:5]) */
+  if (bits == 512 && max >= 7) {
+    if ((xcr0 & 0xe0) != 0xe0) return 0;
+    cpuid(7, 0, r);
+    return (r[1] >> 16) & 1;
+  }
+#elif defined(SIMD_NEON)
+  if (bits == 128) {
+#if defined(__linux__) && defined(HWCAP_ASIMD)
+    return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#else
+    return 1;
+#endif
+  }
+#endif
+
+  return 0;
+}
+
+/* 1 if the CPU has AVX2, which adds the 256-bit gathers */
+static int has_avx2(){
+#ifdef SIMD_X86
+  unsigned int r[4];
+
+  if (!simd_supported(256)) return 0;
+  cpuid(0, 0, r);
+  if (r[0] < 7) return 0;
+  /* CPUID.7.0:EBX[5] is AVX2 */
+  cpuid(7, 0, r);
+  return (r[1] >> 5) & 1;
+#else
+  return 0;
+#endif
+}
+
+/* the widths to run, from --vector-width or every supported one */
+int simd_widths(int *list){
+
+  int all[4] = {SIMD_SCALAR, 128, 256, 512};
+  int i, n = 0;
+
+  if (simd_width != SIMD_ALL) {
+    list[0] = simd_width;
+    return 1;
+  }
+  for (i = 0; i < 4; i++) {
+    if (simd_supported(all[i])) list[n++] = all[i];
+  }
+
+  return n;
+}
+
+/*
+ * The widths to run the gather (or with scatter set the scatter) kernels
+ * with: scalar code and every width with a hardware instruction, or just
+ * the one given with --vector-width. Widths without gather or scatter
+ * instructions fall back to scalar code and are left out.
+ */
+int simd_gather_widths(int *list, int scatter){
+
+  int n = 0;
+
+  if (simd_width == SIMD_ALL || simd_width == SIMD_SCALAR) list[n++] = SIMD_SCALAR;
+  if ((simd_width == SIMD_ALL || simd_width == 256) && !scatter && has_avx2()) list[n++] = 256;
+  if ((simd_width == SIMD_ALL || simd_width == 512) && simd_supported(512)) list[n++] = 512;
+
+  return n;
+}
+
+char *simd_name(int bits){
+
+  switch (bits) {
+  case SIMD_SCALAR: return "scalar";
+#ifdef SIMD_X86
+  case 128: return "SSE2 128-bit";
+  case 256: return "AVX 256-bit";
+  case 512: return "AVX-512 512-bit";
+#else
+  case 128: return "NEON 128-bit";
+#endif
+  }
+
+  return "unknown";
+}
+
+
+/* scalar kernels, four independent sums so the read is not bound by add latency */
+
+SCALAR_KERNEL static double read_scalar(double *a, size_t n){
+
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  size_t i;
+
+  SCALAR_LOOP
+  for (i = 0; i + 3 < n; i += 4) {
+    s0 += a[i];
+    s1 += a[i+1];
+    s2 += a[i+2];
+    s3 += a[i+3];
+  }
+  for (; i < n; i++) s0 += a[i];
+
+  return (s0 + s1) + (s2 + s3);
+}
+
+SCALAR_KERNEL static void write_scalar(double *a, size_t n, double v){
+
+  size_t i;
+
+  SCALAR_LOOP
+  for (i = 0; i < n; i++) a[i] = v;
+}
+
+SCALAR_KERNEL static void copy_scalar(double *dst, double *src, size_t n){
+
+  size_t i;
+
+  SCALAR_LOOP
+  for (i = 0; i < n; i++) dst[i] = src[i];
+}
+
+
+/*
+ * Vector kernels. Every loop iteration moves four vectors, reads keep
+ * four accumulators, and unaligned loads and stores are used since they
+ * cost the same as aligned ones on aligned data. The remainder of the
+ * array is done with scalar code.
+ */
+#ifdef SIMD_X86
+
+__attribute__((target("sse2"))) static double read_128(double *a, size_t n){
+
+  __m128d s0 = _mm_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+  double t[2], sum;
+  size_t i;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    s0 = _mm_add_pd(s0, _mm_loadu_pd(a + i));
+    s1 = _mm_add_pd(s1, _mm_loadu_pd(a + i + 2));
+    s2 = _mm_add_pd(s2, _mm_loadu_pd(a + i + 4));
+    s3 = _mm_add_pd(s3, _mm_loadu_pd(a + i + 6));
+  }
+  _mm_storeu_pd(t, _mm_add_pd(_mm_add_pd(s0, s1), _mm_add_pd(s2, s3)));
+  sum = t[0] + t[1];
+  for (; i < n; i++) sum += a[i];
+
+  return sum;
+}
+
+__attribute__((target("sse2"))) static void write_128(double *a, size_t n, double v){
+
+  __m128d x = _mm_set1_pd(v);
+  size_t i;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    _mm_storeu_pd(a + i, x);
+    _mm_storeu_pd(a + i + 2, x);
+    _mm_storeu_pd(a + i + 4, x);
+    _mm_storeu_pd(a + i + 6, x);
+  }
+  for (; i < n; i++) a[i] = v;
+}
+
+__attribute__((target("sse2"))) static void copy_128(double *dst, double *src, size_t n){
+
+  size_t i;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    _mm_storeu_pd(dst + i, _mm_loadu_pd(src + i));
+    _mm_storeu_pd(dst + i + 2, _mm_loadu_pd(src + i + 2));
+    _mm_storeu_pd(dst + i + 4, _mm_loadu_pd(src + i + 4));
+    _mm_storeu_pd(dst + i + 6, _mm_loadu_pd(src + i + 6));
+  }
+  for (; i < n; i++) dst[i] = src[i];
+}
+
+__attribute__((target("avx"))) static double read_256(double *a, size_t n){
+
+  __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+  double t[4], sum;
+  size_t i;
+
+  for (i = 0; i + 16 <= n; i += 16) {
+    s0 = _mm256_add_pd(s0, _mm256_loadu_pd(a + i));
+    s1 = _mm256_add_pd(s1, _mm256_loadu_pd(a + i + 4));
+    s2 = _mm256_add_pd(s2, _mm256_loadu_pd(a + i + 8));
+    s3 = _mm256_add_pd(s3, _mm256_loadu_pd(a + i + 12));
+  }
+  _mm256_storeu_pd(t, _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+  sum = (t[0] + t[1]) + (t[2] + t[3]);
+  for (; i < n; i++) sum += a[i];
+
+  return sum;
+}
+
+__attribute__((target("avx"))) static void write_256(double *a, size_t n, double v){
+
+  __m256d x = _mm256_set1_pd(v);
+  size_t i;
+
+  for (i = 0; i + 16 <= n; i += 16) {
+    _mm256_storeu_pd(a + i, x);
+    _mm256_storeu_pd(a + i + 4, x);
+    _mm256_storeu_pd(a + i + 8, x);
+    _mm256_storeu_pd(a + i + 12, x);
+  }
+  for (; i < n; i++) a[i] = v;
+}
+
+__attribute__((target("avx"))) static void copy_256(double *dst, double *src, size_t n){
+
+  size_t i;
+
+  for (i = 0; i + 16 <= n; i += 16) {
+    _mm256_storeu_pd(dst + i, _mm256_loadu_pd(src + i));
+    _mm256_storeu_pd(dst + i + 4, _mm256_loadu_pd(src + i + 4));
+    _mm256_storeu_pd(dst + i + 8, _mm256_loadu_pd(src + i + 8));
+    _mm256_storeu_pd(dst + i + 12, _mm256_loadu_pd(src + i + 12));
+  }
+  for (; i < n; i++) dst[i] = src[i];
+}
+
+__attribute__((target("avx512f"))) static double read_512(double *a, size_t n){
+
+  __m512d s0 = _mm512_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+  double sum;
+  size_t i;
+
+  for (i = 0; i + 32 <= n; i += 32) {
+    s0 = _mm512_add_pd(s0, _mm512_loadu_pd(a + i));
+    s1 = _mm512_add_pd(s1, _mm512_loadu_pd(a + i + 8));
+    s2 = _mm512_add_pd(s2, _mm512_loadu_pd(a + i + 16));
+    s3 = _mm512_add_pd(s3, _mm512_loadu_pd(a + i + 24));
+  }
+  sum = _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+  for (; i < n; i++) sum += a[i];
+
+  return sum;
+}
+
+__attribute__((target("avx512f"))) static void write_512(double *a, size_t n, double v){
+
+  __m512d x = _mm512_set1_pd(v);
+  size_t i;
+
+  for (i = 0; i + 32 <= n; i += 32) {
+    _mm512_storeu_pd(a + i, x);
+    _mm512_storeu_pd(a + i + 8, x);
+    _mm512_storeu_pd(a + i + 16, x);
+    _mm512_storeu_pd(a + i + 24, x);
+  }
+  for (; i < n; i++) a[i] = v;
+}
+
+__attribute__((target("avx512f"))) static void copy_512(double *dst, double *src, size_t n){
+
+  size_t i;
+
+  for (i = 0; i + 32 <= n; i += 32) {
+    _mm512_storeu_pd(dst + i, _mm512_loadu_pd(src + i));
+    _mm512_storeu_pd(dst + i + 8, _mm512_loadu_pd(src + i + 8));
+    _mm512_storeu_pd(dst + i + 16, _mm512_loadu_pd(src + i + 16));
+    _mm512_storeu_pd(dst + i + 24, _mm512_loadu_pd(src + i + 24));
+  }
+  for (; i < n; i++) dst[i] = src[i];
+}
+
+#elif defined(SIMD_NEON)
+
+static double read_128(double *a, size_t n){
+
+  float64x2_t s0 = vdupq_n_f64(0.0), s1 = s0, s2 = s0, s3 = s0;
+  double sum;
+  size_t i;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    s0 = vaddq_f64(s0, vld1q_f64(a + i));
+    s1 = vaddq_f64(s1, vld1q_f64(a + i + 2));
+    s2 = vaddq_f64(s2, vld1q_f64(a + i + 4));
+    s3 = vaddq_f64(s3, vld1q_f64(a + i + 6));
+  }
+  sum = vaddvq_f64(vaddq_f64(vaddq_f64(s0, s1), vaddq_f64(s2, s3)));
+  for (; i < n; i++) sum += a[i];
+
+  return sum;
+}
+
+static void write_128(double *a, size_t n, double v){
+
+  float64x2_t x = vdupq_n_f64(v);
+  size_t i;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    vst1q_f64(a + i, x);
+    vst1q_f64(a + i + 2, x);
+    vst1q_f64(a + i + 4, x);
+    vst1q_f64(a + i + 6, x);
+  }
+  for (; i < n; i++) a[i] = v;
+}
+
+static void copy_128(double *dst, double *src, size_t n){
+
+  size_t i;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    vst1q_f64(dst + i, vld1q_f64(src + i));
+    vst1q_f64(dst + i + 2, vld1q_f64(src + i + 2));
+    vst1q_f64(dst + i + 4, vld1q_f64(src + i + 4));
+    vst1q_f64(dst + i + 6, vld1q_f64(src + i + 6));
+  }
+  for (; i < n; i++) dst[i] = src[i];
+}
+
+#endif
+
+
+/* run the kernel of the given width, simd_supported() must have been checked */
+
+double simd_read(int bits, double *a, size_t n){
+
+  switch (bits) {
+#if defined(SIMD_X86) || defined(SIMD_NEON)
+  case 128: return read_128(a, n);
+#endif
+#ifdef SIMD_X86
+  case 256: return read_256(a, n);
+  case 512: return read_512(a, n);
+#endif
+  }
+
+  return read_scalar(a, n);
+}
+
+void simd_write(int bits, double *a, size_t n, double v){
+
+  switch (bits) {
+#if defined(SIMD_X86) || defined(SIMD_NEON)
+  case 128: write_128(a, n, v); return;
+#endif
+#ifdef SIMD_X86
+  case 256: write_256(a, n, v); return;
+  case 512: write_512(a, n, v); return;
+#endif
+  }
+
+  write_scalar(a, n, v);
+}
+
+void simd_copy(int bits, double *dst, double *src, size_t n){
+
+  switch (bits) {
+#if defined(SIMD_X86) || defined(SIMD_NEON)
+  case 128: copy_128(dst, src, n); return;
+#endif
+#ifdef SIMD_X86
+  case 256: copy_256(dst, src, n); return;
+  case 512: copy_512(dst, src, n); return;
+#endif
+  }
+
+  copy_scalar(dst, src, n);
+}
+
+
+/* store modes and cache flushing */
+
+int simd_select_stores(char *m){
+
+  if (strcmp(m, "normal") == 0) simd_nt = 0;
+  else if (strcmp(m, "nt") == 0) {
+#if defined(SIMD_X86) || defined(SIMD_NEON)
+    simd_nt = 1;
+#else
+    fprintf(stderr, "ERROR: non-temporal stores are not supported on this architecture\n");
+    return 1;
+#endif
+  }
+  else {
+    fprintf(stderr, "ERROR: unknown store mode %s, use normal or nt\n", m);
+    return 1;
+  }
+
+  return 0;
+}
+
+/* check that lines can be flushed from user space and find the line size */
+int simd_enable_cold(){
+
+#ifdef SIMD_X86
+  unsigned int r[4], max;
+
+  cpuid(0, 0, r);
+  max = r[0];
+  cpuid(1, 0, r);
+  /* CPUID.1:EDX[19] is CLFSH, EBX[15:8] the flush line size in 8 byte units */
+  if ((r[3] >> 19) & 1) flush_line = ((r[1] >> 8) & 0xff) * 8;
+  if (max >= 7) {
+    /* CPUID.7.0:EBX[23] is CLFLUSHOPT */
+    cpuid(7, 0, r);
+    flush_opt = (r[1] >> 23) & 1;
+  }
+#elif defined(SIMD_NEON)
+  unsigned long long ctr;
+  /* CTR_EL0.DminLine is log2 of the smallest data cache line in words */
+  __asm__ __volatile__ ("mrs %0, ctr_el0" : "=r" (ctr));
+  flush_line = 4UL << ((ctr >> 16) & 0xf);
+#endif
+
+  if (flush_line == 0) {
+    fprintf(stderr, "ERROR: cache lines cannot be flushed on this CPU\n");
+    return 1;
+  }
+  simd_cold = 1;
+
+  return 0;
+}
+
+/* write back and evict every line of [p, p+n) from all cache levels */
+void simd_flush(void *p, size_t n){
+
+  char *c = (char *)((unsigned long)p & ~(unsigned long)(flush_line - 1));
+  char *end = (char *)p + n;
+
+  if (flush_line == 0) return;
+
+#ifdef SIMD_X86
+  if (flush_opt) {
+    for (; c < end; c += flush_line) __asm__ __volatile__ ("clflushopt %0" : "+m" (*c));
+  }
+  else {
+    for (; c < end; c += flush_line) __asm__ __volatile__ ("clflush %0" : "+m" (*c));
+  }
+  __asm__ __volatile__ ("mfence" ::: "memory");
+#elif defined(SIMD_NEON)
+  for (; c < end; c += flush_line) __asm__ __volatile__ ("dc civac, %0" :: "r" (c) : "memory");
+  __asm__ __volatile__ ("dsb ish" ::: "memory");
+#endif
+}
+
+/* fill a[0..n) with v using non-temporal stores, then fence */
+#ifdef SIMD_X86
+__attribute__((target("sse2")))
+#endif
+void simd_stream_ints(int *a, size_t n, int v){
+
+  size_t i = 0;
+
+#ifdef SIMD_X86
+  __m128i x = _mm_set1_epi32(v);
+
+  /* the vector stores need 16 byte alignment */
+  for (; i < n && ((unsigned long)(a + i) & 15); i++) _mm_stream_si32(a + i, v);
+  for (; i + 16 <= n; i += 16) {
+    _mm_stream_si128((__m128i *)(a + i), x);
+    _mm_stream_si128((__m128i *)(a + i + 4), x);
+    _mm_stream_si128((__m128i *)(a + i + 8), x);
+    _mm_stream_si128((__m128i *)(a + i + 12), x);
+  }
+  for (; i < n; i++) _mm_stream_si32(a + i, v);
+#elif defined(SIMD_NEON)
+  unsigned long long x = ((unsigned long long)(unsigned int)v << 32) | (unsigned int)v;
+
+  for (; i < n && ((unsigned long)(a + i) & 15); i++) a[i] = v;
+  for (; i + 16 <= n; i += 16) {
+    __asm__ __volatile__ ("stnp %1, %1, [%0]\n\t"
+                          "stnp %1, %1, [%0, #16]\n\t"
+                          "stnp %1, %1, [%0, #32]\n\t"
+                          "stnp %1, %1, [%0, #48]"
+                          :: "r" (a + i), "r" (x) : "memory");
+  }
+  for (; i < n; i++) a[i] = v;
+#else
+  for (; i < n; i++) a[i] = v;
+#endif
+
+  simd_store_fence();
+}
+
+
+/* indirect kernels: sum a[idx[i]], or store v to a[idx[i]] */
+
+SCALAR_KERNEL static double gather_scalar(double *a, unsigned int *idx, size_t n){
+
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  size_t i;
+
+  SCALAR_LOOP
+  for (i = 0; i + 3 < n; i += 4) {
+    s0 += a[idx[i]];
+    s1 += a[idx[i+1]];
+    s2 += a[idx[i+2]];
+    s3 += a[idx[i+3]];
+  }
+  for (; i < n; i++) s0 += a[idx[i]];
+
+  return (s0 + s1) + (s2 + s3);
+}
+
+SCALAR_KERNEL static void scatter_scalar(double *a, unsigned int *idx, size_t n, double v){
+
+  size_t i;
+
+  SCALAR_LOOP
+  for (i = 0; i < n; i++) a[idx[i]] = v;
+}
+
+#ifdef SIMD_X86
+
+__attribute__((target("avx2"))) static double gather_256(double *a, unsigned int *idx, size_t n){
+
+  __m256d s0 = _mm256_setzero_pd(), s1 = s0;
+  double t[4], sum;
+  size_t i;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    s0 = _mm256_add_pd(s0, _mm256_i32gather_pd(a, _mm_loadu_si128((__m128i *)(idx + i)), 8));
+    s1 = _mm256_add_pd(s1, _mm256_i32gather_pd(a, _mm_loadu_si128((__m128i *)(idx + i + 4)), 8));
+  }
+  _mm256_storeu_pd(t, _mm256_add_pd(s0, s1));
+  sum = (t[0] + t[1]) + (t[2] + t[3]);
+  for (; i < n; i++) sum += a[idx[i]];
+
+  return sum;
+}
+
+__attribute__((target("avx512f"))) static double gather_512(double *a, unsigned int *idx, size_t n){
+
+  __m512d s0 = _mm512_setzero_pd(), s1 = s0;
+  double sum;
+  size_t i;
+
+  for (i = 0; i + 16 <= n; i += 16) {
+    s0 = _mm512_add_pd(s0, _mm512_i32gather_pd(_mm256_loadu_si256((__m256i *)(idx + i)), a, 8));
+    s1 = _mm512_add_pd(s1, _mm512_i32gather_pd(_mm256_loadu_si256((__m256i *)(idx + i + 8)), a, 8));
+  }
+  sum = _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+  for (; i < n; i++) sum += a[idx[i]];
+
+  return sum;
+}
+
+__attribute__((target("avx512f"))) static void scatter_512(double *a, unsigned int *idx, size_t n, double v){
+
+  __m512d x = _mm512_set1_pd(v);
+  size_t i;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    _mm512_i32scatter_pd(a, _mm256_loadu_si256((__m256i *)(idx + i)), x, 8);
+  }
+  for (; i < n; i++) a[idx[i]] = v;
+}
+
+#endif
+
+double simd_gather(int bits, double *a, unsigned int *idx, size_t n){
+
+#ifdef SIMD_X86
+  if (bits == 256) return gather_256(a, idx, n);
+  if (bits == 512) return gather_512(a, idx, n);
+#endif
+
+  return gather_scalar(a, idx, n);
+}
+
+void simd_scatter(int bits, double *a, unsigned int *idx, size_t n, double v){
+
+#ifdef SIMD_X86
+  if (bits == 512) {
+    scatter_512(a, idx, n, v);
+    return;
+  }
+#endif
+
+  scatter_scalar(a, idx, n, v);
+}
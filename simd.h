@@ -0,0 +1,95 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stddef.h>
+
+/*
+ * Explicit vector load/store kernels for the memory benchmarks. Each
+ * kernel exists for scalar code and for 128-bit (SSE2 or NEON), 256-bit
+ * (AVX) and 512-bit (AVX-512F) vectors, so the bandwidth reached with
+ * every ISA level can be compared instead of relying on whatever the
+ * compiler vectorised. Support is detected at runtime with cpuid and
+ * xgetbv on x86 and getauxval on AArch64; --vector-width picks one width,
+ * by default every supported width is run.
+ */
+
+#define SIMD_ALL    -1
+#define SIMD_SCALAR  0
+
+extern int simd_width;
+
+int simd_select(char *);
+int simd_supported(int);
+int simd_widths(int *);
+char *simd_name(int);
+
+double simd_read(int, double *, size_t);
+void simd_write(int, double *, size_t, double);
+void simd_copy(int, double *, double *, size_t);
+
+/* indirect kernels, with hardware gather (AVX2, AVX-512F) and scatter (AVX-512F) */
+int simd_gather_widths(int *, int);
+double simd_gather(int, double *, unsigned int *, size_t);
+void simd_scatter(int, double *, unsigned int *, size_t, double);
+
+/*
+ * Store modes of the contiguous and strided write benchmarks. Ordinary
+ * stores first read every line they miss on (read for ownership), so
+ * the memory traffic is twice the bytes written. With --stores nt the
+ * writes use non-temporal stores (movnti/movntdq on x86, stnp on
+ * AArch64) that go to memory without the read. --cold flushes the arrays
+ * from all cache levels (clflushopt or clflush, dc civac) before every
+ * sample, so every sample starts from a cold cache.
+ */
+
+extern int simd_nt;
+extern int simd_cold;
+
+int simd_select_stores(char *);
+int simd_enable_cold();
+void simd_flush(void *, size_t);
+void simd_stream_ints(int *, size_t, int);
+
+/* a single non-temporal store of v to *p */
+static inline void simd_stream_int(int *p, int v){
+#if defined(__x86_64__) || defined(__i386__)
+  __asm__ __volatile__ ("movnti %1, %0" : "=m" (*p) : "r" (v));
+#elif defined(__aarch64__)
+  /* stnp stores a pair, so write v to the aligned pair holding *p */
+  int *q = (int *)((unsigned long)p & ~7UL);
+  __asm__ __volatile__ ("stnp %w1, %w1, [%0]" :: "r" (q), "r" (v) : "memory");
+#else
+  *p = v;
+#endif
+}
+
+/* order the non-temporal stores before anything that follows */
+static inline void simd_store_fence(){
+#if defined(__x86_64__) || defined(__i386__)
+  __asm__ __volatile__ ("sfence" ::: "memory");
+#elif defined(__aarch64__)
+  __asm__ __volatile__ ("dmb ishst" ::: "memory");
+#endif
+}
+
+#endif
@@ -0,0 +1,311 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <limits.h>
+#include <omp.h>
+
+#include "utils.h"
+#include "timer.h"
+#include "stats.h"
+#include "results.h"
+
+unsigned int stat_min_samples = 5;
+unsigned int stat_max_samples = 100;
+double stat_target_ci = 0.0;
+double stat_min_time = 0.1;
+
+/* two-sided 95% critical values of Student's t for 1..30 degrees of freedom */
+static const double t_crit[30] = {
+  12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+  2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+  2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+static double t_critical(unsigned int dof){
+  if (dof == 0) return 0.0;
+  if (dof <= 30) return t_crit[dof-1];
+  /* close enough to the exact value for larger sample counts */
+  return 1.960 + 2.4 / dof;
+}
+
+static int cmp_double(const void *a, const void *b){
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+/* linear interpolation between closest ranks of a sorted array */
+static double percentile(double *sorted, unsigned int n, double p){
+  double pos = p * (n - 1);
+  unsigned int lo = (unsigned int)pos;
+  if (lo + 1 >= n) return sorted[n-1];
+  return sorted[lo] + (pos - lo) * (sorted[lo+1] - sorted[lo]);
+}
+
+void sampler_init(sampler_t *s, char *title){
+
+  s->title = title;
+  s->n = 0;
+  s->running = 0;
+  s->calibrating = 0;
+  s->reps = NULL;
+  s->ops = 0.0;
+  s->bytes = 0.0;
+  s->chain = 0.0;
+  memset(s->counts, 0, sizeof(s->counts));
+  s->counted = 0;
+
+  s->nthreads = omp_get_max_threads();
+  s->nthreads_seen = 0;
+  s->slowest_sum = 0.0;
+  s->fastest_sum = 0.0;
+  s->timed = 0;
+  s->stamps = (thread_stamp_t *)calloc(s->nthreads, sizeof(thread_stamp_t));
+  s->thread_sum = (double *)calloc(s->nthreads, sizeof(double));
+  if (!s->stamps || !s->thread_sum) {
+    fprintf(stderr, "ERROR: out of memory in sampler_init\n");
+    s->nthreads = 0;
+  }
+
+  s->cap = stat_max_samples;
+  if (s->cap < stat_min_samples) s->cap = stat_min_samples;
+  if (s->cap == 0) s->cap = 1;
+
+  s->samples = (double *)malloc(s->cap * sizeof(double));
+  if (!s->samples) {
+    fprintf(stderr, "ERROR: out of memory in sampler_init\n");
+    s->cap = 0;
+  }
+}
+
+/* called by every thread of a parallel region once its setup is done */
+void sampler_thread_start(sampler_t *s){
+
+  int id = omp_get_thread_num();
+
+  # pragma omp barrier
+  if (id < s->nthreads) s->stamps[id].start = timer_read();
+}
+
+void sampler_thread_stop(sampler_t *s){
+
+  unsigned long long end = timer_read();
+  int id = omp_get_thread_num();
+
+  if (id < s->nthreads) s->stamps[id].end = end;
+}
+
+/* accumulate the per-thread durations of the sample just finished */
+static void sampler_thread_times(sampler_t *s){
+
+  int t, seen = 0;
+  double d, slowest = 0.0, fastest = 0.0;
+
+  for (t = 0; t < s->nthreads; t++) {
+    if (!s->stamps[t].start || !s->stamps[t].end) break;
+    seen++;
+  }
+  if (seen == 0) return;
+
+  for (t = 0; t < seen; t++) {
+    d = timer_seconds(s->stamps[t].end - s->stamps[t].start);
+    s->thread_sum[t] += d;
+    if (t == 0 || d > slowest) slowest = d;
+    if (t == 0 || d < fastest) fastest = d;
+  }
+  s->slowest_sum += slowest;
+  s->fastest_sum += fastest;
+  if (seen > s->nthreads_seen) s->nthreads_seen = seen;
+  s->timed++;
+}
+
+void sampler_start(sampler_t *s){
+  if (s->nthreads) memset(s->stamps, 0, s->nthreads * sizeof(thread_stamp_t));
+  s->running = 1;
+  perf_start();
+  s->start = timer_read();
+}
+
+void sampler_stop(sampler_t *s){
+
+  unsigned long long end = timer_read();
+  double counts[PERF_NEVENTS];
+  int e;
+
+  if (!s->running) return;
+  s->running = 0;
+
+  if (s->n < s->cap) {
+    s->samples[s->n++] = timer_seconds(end - s->start);
+  }
+
+  if (perf_stop(counts)) {
+    for (e = 0; e < PERF_NEVENTS; e++) {
+      if (counts[e] < 0 || s->counts[e] < 0) s->counts[e] = -1;
+      else s->counts[e] += counts[e];
+    }
+    s->counted++;
+  }
+
+  sampler_thread_times(s);
+}
+
+/* grow *reps until the region runs for at least stat_min_time seconds */
+void sampler_calibrate(sampler_t *s, unsigned long *reps){
+  s->reps = reps;
+  s->calibrating = 1;
+  if (*reps == 0) *reps = 1;
+}
+
+/* consume the last sample as a calibration run, return 1 once calibrated */
+static int sampler_calibrated(sampler_t *s){
+
+  double d, factor;
+
+  if (s->n == 0) return 0;
+  d = s->samples[--s->n];
+
+  /* calibration runs do not count towards the counter totals either */
+  memset(s->counts, 0, sizeof(s->counts));
+  s->counted = 0;
+  if (s->nthreads) memset(s->thread_sum, 0, s->nthreads * sizeof(double));
+  s->slowest_sum = 0.0;
+  s->fastest_sum = 0.0;
+  s->nthreads_seen = 0;
+  s->timed = 0;
+
+  if (d >= stat_min_time || *s->reps > ULONG_MAX / 10) {
+    s->calibrating = 0;
+    return 1;
+  }
+
+  /* aim slightly above the target, but never grow by more than 10x */
+  factor = (d > 0.0) ? 1.1 * stat_min_time / d : 10.0;
+  if (factor < 2.0) factor = 2.0;
+  if (factor > 10.0) factor = 10.0;
+  *s->reps = (unsigned long)(*s->reps * factor);
+
+  return 0;
+}
+
+/* decide whether another sample is required */
+int sampler_done(sampler_t *s){
+
+  sample_stats_t st;
+  unsigned int min = stat_min_samples ? stat_min_samples : 1;
+
+  if (s->n >= s->cap) return 1;
+  if (s->n < min) return 0;
+  if (stat_target_ci <= 0.0) return 1;
+
+  sampler_stats(s, &st);
+  if (st.mean <= 0.0) return 1;
+
+  return (st.ci_hi - st.mean) / st.mean <= stat_target_ci;
+}
+
+/* close the sample in progress (if any) and start a new one if needed */
+int sampler_next(sampler_t *s){
+
+  sampler_stop(s);
+  if (s->calibrating && !sampler_calibrated(s)) {
+    sampler_start(s);
+    return 1;
+  }
+  if (sampler_done(s)) return 0;
+  sampler_start(s);
+
+  return 1;
+}
+
+void sampler_stats(sampler_t *s, sample_stats_t *st){
+
+  unsigned int i;
+  double sum = 0.0, sq = 0.0, half;
+  double *sorted;
+
+  memset(st, 0, sizeof(sample_stats_t));
+  st->n = s->n;
+  if (s->n == 0) return;
+
+  sorted = (double *)malloc(s->n * sizeof(double));
+  if (!sorted) return;
+  memcpy(sorted, s->samples, s->n * sizeof(double));
+  qsort(sorted, s->n, sizeof(double), cmp_double);
+
+  for (i = 0; i < s->n; i++) sum += sorted[i];
+  st->mean = sum / s->n;
+  for (i = 0; i < s->n; i++) sq += (sorted[i] - st->mean) * (sorted[i] - st->mean);
+  st->stddev = (s->n > 1) ? sqrt(sq / (s->n - 1)) : 0.0;
+
+  st->min = sorted[0];
+  st->max = sorted[s->n-1];
+  st->median = percentile(sorted, s->n, 0.50);
+  st->p90 = percentile(sorted, s->n, 0.90);
+  st->p99 = percentile(sorted, s->n, 0.99);
+
+  half = t_critical(s->n - 1) * st->stddev / sqrt((double)s->n);
+  st->ci_lo = st->mean - half;
+  st->ci_hi = st->mean + half;
+
+  free(sorted);
+}
+
+/* record the work done by one sample of the region for the derived rates; */
+/* call it after the sampling loop so calibrated counts are final          */
+void sampler_set_work(sampler_t *s, double ops, double bytes){
+  s->ops = ops;
+  s->bytes = bytes;
+}
+
+/*
+ * For regions that time a chain of dependent operations (each thread
+ * chasing pointers, or passing a message back and forth), the number of
+ * links each thread follows in one sample; the report then gives the
+ * latency of one link.
+ */
+void sampler_set_latency(sampler_t *s, double chain){
+  s->chain = chain;
+}
+
+/* report the statistics of a region, release the sampler and return the median */
+double sampler_report(sampler_t *s){
+
+  sample_stats_t st;
+
+  sampler_stats(s, &st);
+  results_record(s, &st);
+
+  free(s->samples);
+  free(s->stamps);
+  free(s->thread_sum);
+  s->samples = NULL;
+  s->stamps = NULL;
+  s->thread_sum = NULL;
+  s->cap = 0;
+  s->nthreads = 0;
+
+  return st.median;
+}
@@ -0,0 +1,102 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include "perfctr.h"
+
+/*
+ * Repetition engine for timed regions. A region is wrapped in
+ *
+ *   sampler_init(&s, "title");
+ *   while(sampler_next(&s)){
+ *     ... region ...
+ *   }
+ *   sampler_report(&s);
+ *
+ * and is executed until at least stat_min_samples samples have been
+ * taken and, if stat_target_ci is non-zero, the half-width of the 95%
+ * confidence interval of the mean falls below that fraction of the mean
+ * (or stat_max_samples is reached).
+ *
+ * Regions whose length is set by an iteration count can call
+ * sampler_calibrate() before the loop: the count is then grown until one
+ * execution of the region takes at least stat_min_time seconds, and only
+ * then are samples recorded.
+ *
+ * Inside a parallel region each thread may bracket its own share of the
+ * work with sampler_thread_start()/sampler_thread_stop(). The start waits
+ * at a barrier so all threads begin together, and the report then also
+ * gives per-thread durations and the imbalance between threads.
+ */
+
+/* per-thread timestamps, padded so threads do not share a cache line */
+typedef struct {
+  unsigned long long start, end;
+  char pad[48];
+} thread_stamp_t;
+
+typedef struct {
+  char *title;
+  unsigned int n;           /* number of samples taken so far */
+  unsigned int cap;         /* capacity of the samples array */
+  double *samples;          /* duration of each sample in seconds */
+  int running;              /* a sample is currently being timed */
+  unsigned long long start; /* timer value at the start of the sample */
+  int calibrating;          /* still growing *reps, samples are discarded */
+  unsigned long *reps;      /* iteration count of the region, if any */
+  double ops, bytes;        /* work done by one sample, for derived rates */
+  double chain;             /* dependent operations per thread in one sample, for latency */
+  double counts[PERF_NEVENTS]; /* counter totals over all samples, -1 if unavailable */
+  unsigned int counted;     /* number of samples with counter values */
+  int nthreads;             /* number of per-thread slots */
+  int nthreads_seen;        /* largest team that stamped a sample */
+  thread_stamp_t *stamps;   /* per-thread timestamps of the current sample */
+  double *thread_sum;       /* per-thread duration totals over samples */
+  double slowest_sum, fastest_sum;
+  unsigned int timed;       /* number of samples with per-thread timestamps */
+} sampler_t;
+
+typedef struct {
+  unsigned int n;
+  double min, max, median, mean, p90, p99, stddev;
+  double ci_lo, ci_hi;      /* 95% confidence interval of the mean */
+} sample_stats_t;
+
+extern unsigned int stat_min_samples;
+extern unsigned int stat_max_samples;
+extern double stat_target_ci;
+extern double stat_min_time;
+
+void sampler_init(sampler_t *, char *);
+void sampler_calibrate(sampler_t *, unsigned long *);
+int sampler_next(sampler_t *);
+void sampler_start(sampler_t *);
+void sampler_stop(sampler_t *);
+int sampler_done(sampler_t *);
+void sampler_stats(sampler_t *, sample_stats_t *);
+void sampler_thread_start(sampler_t *);
+void sampler_thread_stop(sampler_t *);
+void sampler_set_work(sampler_t *, double, double);
+void sampler_set_latency(sampler_t *, double);
+double sampler_report(sampler_t *);
+
+#endif
@@ -0,0 +1,139 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "utils.h"
+#include "timer.h"
+
+int timer_backend = TIMER_CLOCK;
+double timer_hz = 1e9;
+double timer_cycle_hz = 0.0;
+
+/* requested backend: -1 auto, otherwise TIMER_CLOCK or TIMER_TSC */
+static int timer_request = -1;
+
+int timer_select(char *name){
+
+  if (strcmp(name, "auto") == 0) timer_request = -1;
+  else if (strcmp(name, "clock") == 0) timer_request = TIMER_CLOCK;
+  else if (strcmp(name, "tsc") == 0) timer_request = TIMER_TSC;
+  else {
+    fprintf(stderr, "ERROR: unknown timer %s, use auto, tsc or clock\n", name);
+    return 1;
+  }
+
+  return 0;
+}
+
+/* check that the counter ticks at a constant rate whatever the core does */
+static int tsc_invariant(){
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int eax, ebx, ecx, edx;
+
+  __asm__ __volatile__ ("cpuid" : "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx) : "a" (0x80000000));
+  if (eax < 0x80000007) return 0;
+
+  /* CPUID.80000007H:EDX[8] is the invariant TSC bit */
+  __asm__ __volatile__ ("cpuid" : "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx) : "a" (0x80000007));
+  return (edx >> 8) & 1;
+#elif defined(__aarch64__)
+  /* the generic timer runs at a fixed frequency by definition */
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+/* measure the counter frequency against CLOCK over about 50 ms */
+static double tsc_calibrate(){
+
+  struct timespec t0, t1, elapsed, nap;
+  unsigned long long c0, c1;
+  double secs;
+  int saved = timer_backend;
+
+  timer_backend = TIMER_TSC;
+  nap.tv_sec = 0;
+  nap.tv_nsec = 50000000L;
+
+  clock_gettime(CLOCK, &t0);
+  c0 = timer_read();
+  nanosleep(&nap, NULL);
+  clock_gettime(CLOCK, &t1);
+  c1 = timer_read();
+
+  timer_backend = saved;
+
+  sub_time_hr(&elapsed, &t0, &t1);
+  secs = elapsed.tv_sec + ((double)elapsed.tv_nsec/1000000000);
+  if (secs <= 0.0) return 0.0;
+
+  return (double)(c1 - c0) / secs;
+}
+
+void timer_init(){
+
+  int have_tsc = 0;
+  double hz = 0.0;
+
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+  have_tsc = tsc_invariant();
+  if (have_tsc) hz = tsc_calibrate();
+  if (hz <= 0.0) have_tsc = 0;
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+  if (have_tsc) timer_cycle_hz = hz;
+#endif
+
+  if (timer_request == TIMER_TSC && !have_tsc) {
+    fprintf(stderr, "WARNING: no invariant time stamp counter, using clock_gettime\n");
+  }
+
+  if (have_tsc && timer_request != TIMER_CLOCK) {
+    timer_backend = TIMER_TSC;
+    timer_hz = hz;
+    printf("Timer is the time stamp counter at %.3f MHz.\n", hz / 1e6);
+  }
+  else {
+    timer_backend = TIMER_CLOCK;
+    timer_hz = 1e9;
+    printf("Timer is clock_gettime.\n");
+  }
+}
+
+/* resolution of the active timer in seconds */
+double timer_resolution(){
+
+  struct timespec res;
+
+  if (timer_backend == TIMER_TSC) return 1.0 / timer_hz;
+
+#ifdef __MACH__
+  return 1e-9;
+#else
+  if (clock_getres(CLOCK, &res) != 0) return 1e-9;
+  return res.tv_sec + ((double)res.tv_nsec/1000000000);
+#endif
+}
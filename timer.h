@@ -0,0 +1,74 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <time.h>
+
+#include "utils.h"
+
+/*
+ * Timer backends for the sampler. TIMER_CLOCK reads clock_gettime(CLOCK),
+ * TIMER_TSC reads the time stamp counter (rdtscp on x86, cntvct_el0 on
+ * AArch64), which is much cheaper to read than a system call and so
+ * suits very short regions. timer_init() picks the backend and, for the
+ * counter, calibrates its frequency against CLOCK.
+ */
+
+#define TIMER_CLOCK 0
+#define TIMER_TSC   1
+
+extern int timer_backend;
+extern double timer_hz;         /* ticks per second of the active backend */
+extern double timer_cycle_hz;   /* TSC frequency on x86, 0 if unknown */
+
+int timer_select(char *);
+void timer_init();
+double timer_resolution();
+
+/* read the current timer value in ticks */
+static inline unsigned long long timer_read(){
+
+  struct timespec ts;
+
+  if (timer_backend == TIMER_TSC) {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int lo, hi, aux;
+    /* rdtscp waits for earlier instructions, lfence stops later ones starting early */
+    __asm__ __volatile__ ("rdtscp\n\tlfence" : "=a" (lo), "=d" (hi), "=c" (aux) :: "memory");
+    return ((unsigned long long)hi << 32) | lo;
+#elif defined(__aarch64__)
+    unsigned long long v;
+    __asm__ __volatile__ ("isb\n\tmrs %0, cntvct_el0" : "=r" (v) :: "memory");
+    return v;
+#endif
+  }
+
+  clock_gettime(CLOCK, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* convert a tick difference to seconds */
+static inline double timer_seconds(unsigned long long ticks){
+  return (double)ticks / timer_hz;
+}
+
+#endif
@@ -0,0 +1,270 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "rng.h"
+#include "trace.h"
+
+char *trace_spec = NULL;
+char *trace_out = NULL;
+
+#define TRACE_MAGIC "MTRC"
+
+/* append one entry, growing the list as needed; 1 if out of memory */
+static int push(trace_t *tr, size_t *cap, unsigned long long v){
+
+  unsigned long long *p;
+
+  if (tr->n == *cap) {
+    *cap = *cap ? 2 * *cap : 1024;
+    p = (unsigned long long *)realloc(tr->idx, *cap * sizeof(unsigned long long));
+    if (!p) return 1;
+    tr->idx = p;
+  }
+  tr->idx[tr->n++] = v;
+  if (v & TRACE_WRITE) tr->writes++;
+
+  return 0;
+}
+
+/* read a trace file, wrapping indices to the array of n elements */
+static int load(char *file, size_t n, trace_t *tr){
+
+  FILE *f;
+  char magic[4];
+  unsigned int width, e4;
+  unsigned long long count, e8, i;
+  long end;
+
+  f = fopen(file, "rb");
+  if (!f) return 1;
+
+  if (fread(magic, 1, 4, f) != 4 || memcmp(magic, TRACE_MAGIC, 4) != 0
+      || fread(&width, sizeof(width), 1, f) != 1 || (width != 4 && width != 8)
+      || fread(&count, sizeof(count), 1, f) != 1) {
+    fprintf(stderr, "ERROR: %s is not a trace file\n", file);
+    fclose(f);
+    return 1;
+  }
+
+  /* the count comes from the file: it has to fit the entries actually there */
+  if (fseek(f, 0, SEEK_END) != 0 || (end = ftell(f)) < 16 || fseek(f, 16, SEEK_SET) != 0) {
+    fprintf(stderr, "ERROR: unable to read %s\n", file);
+    fclose(f);
+    return 1;
+  }
+  if (count > (unsigned long long)(end - 16) / width || count > SIZE_MAX / sizeof(unsigned long long)) {
+    fprintf(stderr, "ERROR: %s holds fewer than the %llu entries its header gives\n", file, count);
+    fclose(f);
+    return 1;
+  }
+
+  tr->idx = (unsigned long long *)malloc((count ? count : 1) * sizeof(unsigned long long));
+  if (!tr->idx) {
+    printf("Out Of Memory: could not allocate space for the trace.\n");
+    fclose(f);
+    return 1;
+  }
+
+  for (i = 0; i < count; i++) {
+    if (width == 4) {
+      if (fread(&e4, 4, 1, f) != 1) break;
+      e8 = (e4 & 0x7fffffffU) % n;
+      if (e4 >> 31) e8 |= TRACE_WRITE;
+    }
+    else {
+      if (fread(&e8, 8, 1, f) != 1) break;
+      e8 = ((e8 & ~TRACE_WRITE) % n) | (e8 & TRACE_WRITE);
+    }
+    tr->idx[i] = e8;
+    if (e8 & TRACE_WRITE) tr->writes++;
+  }
+  tr->n = i;
+  fclose(f);
+
+  if (i < count) {
+    fprintf(stderr, "ERROR: %s ends after %llu of %llu entries\n", file, i, count);
+    return 1;
+  }
+
+  return 0;
+}
+
+/* generate one phase of a pattern over n elements */
+static int phase(char *name, char *arg, size_t n, trace_t *tr, size_t *cap, rng_t *rng){
+
+  size_t i, j, k, b, w, h, count;
+  size_t *order;
+  char *end;
+
+  count = n;
+  if (arg) {
+    count = strtoull(arg, &end, 10);
+    if (*arg == '\0' || *end != '\0' || count == 0) {
+      fprintf(stderr, "ERROR: invalid parameter %s of trace pattern %s\n", arg, name);
+      return 1;
+    }
+  }
+
+  if (strcmp(name, "seq") == 0) {
+    for (i = 0; i < n; i++) if (push(tr, cap, i)) return 1;
+  }
+  else if (strcmp(name, "stride") == 0) {
+    for (j = 0; j < count && j < n; j++) {
+      for (i = j; i < n; i += count) if (push(tr, cap, i)) return 1;
+    }
+  }
+  else if (strcmp(name, "gather") == 0 || strcmp(name, "scatter") == 0) {
+    unsigned long long wr = (name[0] == 's') ? TRACE_WRITE : 0;
+    for (i = 0; i < count; i++) if (push(tr, cap, rng_below(rng, n) | wr)) return 1;
+  }
+  else if (strcmp(name, "blocked") == 0) {
+    b = arg ? count : 64;
+    h = (n + b - 1) / b;
+    order = (size_t *)malloc(h * sizeof(size_t));
+    if (!order) return 1;
+    for (i = 0; i < h; i++) order[i] = i;
+    for (i = h - 1; i > 0; i--) {
+      k = rng_below(rng, i + 1);
+      j = order[i]; order[i] = order[k]; order[k] = j;
+    }
+    for (i = 0; i < h; i++) {
+      for (j = order[i] * b; j < order[i] * b + b && j < n; j++) {
+        if (push(tr, cap, j)) { free(order); return 1; }
+      }
+    }
+    free(order);
+  }
+  else if (strcmp(name, "stencil") == 0) {
+    w = arg ? count : (size_t)sqrt((double)n);
+    h = w ? n / w : 0;
+    if (w < 3 || h < 3) {
+      fprintf(stderr, "ERROR: the array is too small for a stencil on rows of %zu elements\n", w);
+      return 1;
+    }
+    for (i = 1; i < h - 1; i++) {
+      for (j = 1; j < w - 1; j++) {
+        k = i * w + j;
+        if (push(tr, cap, k) || push(tr, cap, k - w) || push(tr, cap, k + w)
+            || push(tr, cap, k - 1) || push(tr, cap, k + 1) || push(tr, cap, k | TRACE_WRITE)) return 1;
+      }
+    }
+  }
+  else {
+    fprintf(stderr, "ERROR: unknown trace pattern %s, use seq, stride, gather, scatter, blocked or stencil\n", name);
+    return 1;
+  }
+
+  return 0;
+}
+
+/*
+ * Build the trace named by spec for an array of n elements: load it if
+ * spec is a file, otherwise generate it from the pattern. Returns 0 on
+ * success.
+ */
+int trace_build(char *spec, size_t n, trace_t *tr){
+
+  char *copy, *tok, *save, *arg;
+  size_t cap = 0;
+  rng_t rng;
+  FILE *f;
+
+  memset(tr, 0, sizeof(trace_t));
+
+  if ((f = fopen(spec, "rb")) != NULL) {
+    fclose(f);
+    if (load(spec, n, tr)) {
+      trace_free(tr);
+      return 1;
+    }
+    return 0;
+  }
+
+  /* the same seed gives the same trace */
+  rng_init(&rng, 0x7472616365ULL);
+
+  copy = strdup(spec);
+  if (!copy) return 1;
+  for (tok = strtok_r(copy, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+    arg = strchr(tok, ':');
+    if (arg) *arg++ = '\0';
+    if (phase(tok, arg, n, tr, &cap, &rng)) {
+      free(copy);
+      trace_free(tr);
+      return 1;
+    }
+  }
+  free(copy);
+
+  if (tr->n == 0) {
+    fprintf(stderr, "ERROR: the trace %s is empty\n", spec);
+    return 1;
+  }
+
+  return 0;
+}
+
+/* write the trace to file, with 4 byte entries if the indices fit */
+int trace_save(trace_t *tr, char *file){
+
+  FILE *f;
+  unsigned int width = 4, e4;
+  unsigned long long count = tr->n;
+  size_t i;
+
+  for (i = 0; i < tr->n; i++) {
+    if ((tr->idx[i] & ~TRACE_WRITE) > 0x7fffffffULL) width = 8;
+  }
+
+  f = fopen(file, "wb");
+  if (!f) {
+    fprintf(stderr, "ERROR: cannot write the trace to %s\n", file);
+    return 1;
+  }
+  fwrite(TRACE_MAGIC, 1, 4, f);
+  fwrite(&width, sizeof(width), 1, f);
+  fwrite(&count, sizeof(count), 1, f);
+  for (i = 0; i < tr->n; i++) {
+    if (width == 4) {
+      e4 = (unsigned int)(tr->idx[i] & 0x7fffffffULL) | ((tr->idx[i] & TRACE_WRITE) ? 0x80000000U : 0);
+      fwrite(&e4, 4, 1, f);
+    }
+    else fwrite(&tr->idx[i], 8, 1, f);
+  }
+  if (fclose(f) != 0) {
+    fprintf(stderr, "ERROR: cannot write the trace to %s\n", file);
+    return 1;
+  }
+
+  return 0;
+}
+
+void trace_free(trace_t *tr){
+  free(tr->idx);
+  tr->idx = NULL;
+  tr->n = 0;
+  tr->writes = 0;
+}
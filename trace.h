@@ -0,0 +1,59 @@
+/* Copyright (c) 2015 The University of Edinburgh. */
+
+/* 
+* This software was developed as part of the                       
+* EC FP7 funded project Adept (Project ID: 610490)                 
+* www.adept-project.eu                                            
+*/
+
+/* Licensed under the Apache License, Version 2.0 (the "License"); */
+/* you may not use this file except in compliance with the License. */
+/* You may obtain a copy of the License at */
+
+/*     http://www.apache.org/licenses/LICENSE-2.0 */
+
+/* Unless required by applicable law or agreed to in writing, software */
+/* distributed under the License is distributed on an "AS IS" BASIS, */
+/* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/* See the License for the specific language governing permissions and */
+/* limitations under the License. */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+
+/*
+ * Access traces replayed by the trace memory benchmark. A trace is a
+ * list of element indices into the per-thread array of 8 byte elements;
+ * the top bit of an entry marks a write, all other entries are reads.
+ * --trace names either a trace file or a pattern of comma separated
+ * phases, each covering the array once unless given a count:
+ *   seq               contiguous reads
+ *   stride:S          reads with a stride of S elements, every element once
+ *   gather[:N]        N random reads
+ *   scatter[:N]       N random writes
+ *   blocked:B         blocks of B elements read contiguously, in random order
+ *   stencil[:W]       2D 5-point stencil on rows of W elements: read the
+ *                     point and its four neighbours, write the point
+ * A trace file starts with the magic "MTRC", the entry width in bytes
+ * (4 or 8, 32 bit) and the entry count (64 bit), followed by the entries,
+ * all in the byte order of the host. Indices beyond the array wrap.
+ */
+
+#define TRACE_WRITE (1ULL << 63)
+
+typedef struct {
+  unsigned long long *idx;
+  size_t n;
+  size_t writes;
+} trace_t;
+
+extern char *trace_spec;
+extern char *trace_out;
+
+int trace_build(char *, size_t, trace_t *);
+int trace_save(trace_t *, char *);
+void trace_free(trace_t *);
+
+#endif
@@ -20,11 +20,15 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include <sys/time.h>
 #include <signal.h>
 
 #include "utils.h"
+#include "stats.h"
+
+volatile sig_atomic_t stop;
 
 #ifdef __MACH__
 
@@ -69,37 +73,39 @@ double elapsed_time_hr(struct timespec t1, struct timespec t2, char * title){
 
 void loop_timer(unsigned long limit){
 
-  struct timespec t1, t2;
-  int index;
+  sampler_t smp;
+  unsigned long index;
 
-  clock_gettime(CLOCK, &t1);
-  for(index=0; index<limit; index++) {
-    /* __asm__ ("nop"); */
+  sampler_init(&smp, "Loop on its own");
+  while(sampler_next(&smp)){
+    for(index=0; index<limit; index++) {
+      /* __asm__ ("nop"); */
+    }
   }
-  clock_gettime(CLOCK, &t2);
-
-
-  elapsed_time_hr(t1, t2, "Loop on its own");
+  sampler_report(&smp);
 }
 
-void loop_timer_nop(unsigned long limit){
+/* a limit of 0 calibrates the loop count, which is returned */
+unsigned long loop_timer_nop(unsigned long limit){
 
-  struct timespec t1, t2;
-  int index;
+  sampler_t smp;
+  unsigned long index;
 
-  clock_gettime(CLOCK, &t1);
-  for(index=0; index<limit; index++) {
-    __asm__ ("nop");
+  sampler_init(&smp, "Loop on its own with nop");
+  if (limit == 0) sampler_calibrate(&smp, &limit);
+  while(sampler_next(&smp)){
+    for(index=0; index<limit; index++) {
+      __asm__ ("nop");
+    }
   }
-  clock_gettime(CLOCK, &t2);
-
+  sampler_report(&smp);
 
-  elapsed_time_hr(t1, t2, "Loop on its own with nop");
+  return limit;
 }
 
 void warmup_loop(unsigned long limit){
 
-  int index;
+  unsigned long index;
 
   for(index=0; index<limit; index++) {
     __asm__ ("nop");
@@ -180,3 +186,78 @@ int sub_time_hr(struct timespec* result, struct timespec* start, struct timespec
 
   return end->tv_sec < start->tv_sec;
 }
+
+/* write a byte count such as 4 KB or 1.5 MB into buf and return it */
+char *format_bytes(char *buf, size_t bytes){
+
+  char *unit[] = {"B", "KB", "MB", "GB", "TB"};
+  double v = (double)bytes;
+  int u = 0;
+
+  while (v >= 1024.0 && u < 4) {
+    v /= 1024.0;
+    u++;
+  }
+  if (v == (double)(unsigned long)v) sprintf(buf, "%lu %s", (unsigned long)v, unit[u]);
+  else sprintf(buf, "%.1f %s", v, unit[u]);
+
+  return buf;
+}
+
+/*
+ * Parse a size such as 200, 64K, 1.5M or 3G into *value. K, M, G and T
+ * (optionally followed by B) are powers of 1024 and B alone means bytes;
+ * *has_unit tells whether any suffix was given. Returns 0 on success.
+ */
+int parse_size(char *str, size_t *value, int *has_unit){
+
+  char *end;
+  double v, scale = 1.0;
+
+  v = strtod(str, &end);
+  if (end == str || v < 0.0) return 1;
+
+  *has_unit = 1;
+  switch (*end) {
+  case 'k': case 'K': scale = 1024.0; end++; break;
+  case 'm': case 'M': scale = 1048576.0; end++; break;
+  case 'g': case 'G': scale = 1073741824.0; end++; break;
+  case 't': case 'T': scale = 1099511627776.0; end++; break;
+  case 'b': case 'B': break;
+  default: *has_unit = 0; break;
+  }
+  if (*end == 'b' || *end == 'B') end++;
+  if (*end != '\0') return 1;
+
+  /* without a unit only whole numbers make sense */
+  v *= scale;
+  if (v >= 18446744073709551616.0) return 1;
+  if (v != (double)(size_t)v && !*has_unit) return 1;
+  *value = (size_t)v;
+
+  return 0;
+}
+
+/*
+ * Parse a comma separated list of at most max sizes into list; 'what'
+ * names an entry in error messages. Returns the count, or 0 on error.
+ */
+int parse_size_list(char *str, char *what, size_t *list, int max){
+
+  char *copy, *tok;
+  int n = 0, unit;
+
+  copy = strdup(str);
+  if (!copy) return 0;
+  for (tok = strtok(copy, ","); tok; tok = strtok(NULL, ",")) {
+    if (n == max || parse_size(tok, &list[n], &unit) || list[n] == 0) {
+      fprintf(stderr, "ERROR: invalid %s %s\n", what, tok);
+      free(copy);
+      return 0;
+    }
+    n++;
+  }
+  free(copy);
+
+  return n;
+}
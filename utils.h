@@ -18,8 +18,9 @@
 /* See the License for the specific language governing permissions and */
 /* limitations under the License. */
 
+#include <stddef.h>
 #include <signal.h>
-volatile sig_atomic_t stop;
+extern volatile sig_atomic_t stop;
 
 #ifdef __MACH__
 #include <mach/clock.h>
@@ -41,8 +42,11 @@ void clock_gettime (void*, struct timespec*);
 
 double elapsed_time_hr(struct timespec, struct timespec, char *);
 void loop_timer(unsigned long);
-void loop_timer_nop(unsigned long);
+unsigned long loop_timer_nop(unsigned long);
 void warmup_loop(unsigned long);
 void interrupt_handler(int);
 void discrete_elapsed_hr(struct timespec*, struct timespec*, unsigned int*, char*);
 int sub_time_hr(struct timespec*, struct timespec*, struct timespec*);
+char *format_bytes(char *, size_t);
+int parse_size(char *, size_t *, int *);
+int parse_size_list(char *, char *, size_t *, int);